@@ -0,0 +1,110 @@
+/*
+ * ConcurrentMap scaling at 1/2/4/8/16 threads against a HashMap behind one
+ * global mutex. Build from the repository root:
+ *
+ *   gcc -O2 -pthread bench/concurrentmaps.c src/maps.c src/epochs.c \
+ *       src/arrays.c src/strings.c src/pointers.c -Iinclude -lm -o bin/bench_concurrentmaps
+ *
+ * Usage: bench_concurrentmaps [keys] [opsPerThread] [writePercent]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include "../include/maps.h"
+
+#define BENCH_MAX_THREADS 16
+
+typedef struct {
+    ConcurrentMap cmap;
+    HashMap map;
+    pthread_mutex_t* lock;
+    uint64_t keys;
+    uint64_t ops;
+    unsigned writePercent;
+    uint64_t seed;
+    uint64_t hits;
+} BenchWorker;
+
+static double _now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static inline uint64_t _next(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static void* _concurrentWorker(void* arg) {
+    BenchWorker* w = (BenchWorker*)arg;
+    uint64_t state = w->seed;
+    for (uint64_t i = 0; i < w->ops; i++) {
+        uint64_t r = _next(&state);
+        uint64_t key = r % w->keys;
+        uint64_t value = key;
+        if ((r >> 40) % 100 < w->writePercent) concurrentMapPut(w->cmap, &key, &value);
+        else w->hits += concurrentMapGet(w->cmap, &key, &value);
+    }
+    return NULL;
+}
+
+static void* _mutexWorker(void* arg) {
+    BenchWorker* w = (BenchWorker*)arg;
+    uint64_t state = w->seed;
+    for (uint64_t i = 0; i < w->ops; i++) {
+        uint64_t r = _next(&state);
+        uint64_t key = r % w->keys;
+        uint64_t value = key;
+        pthread_mutex_lock(w->lock);
+        if ((r >> 40) % 100 < w->writePercent) mapPut(w->map, &key, &value);
+        else w->hits += mapGet(w->map, &key) != NULL;
+        pthread_mutex_unlock(w->lock);
+    }
+    return NULL;
+}
+
+static double _run(void* (*fn)(void*), BenchWorker* proto, int threads) {
+    pthread_t tids[BENCH_MAX_THREADS];
+    BenchWorker workers[BENCH_MAX_THREADS];
+    double start = _now();
+    for (int i = 0; i < threads; i++) {
+        workers[i] = *proto;
+        workers[i].seed = proto->seed + (uint64_t)i * 0x1000193;
+        pthread_create(&tids[i], NULL, fn, &workers[i]);
+    }
+    for (int i = 0; i < threads; i++) pthread_join(tids[i], NULL);
+    double elapsed = _now() - start;
+    return (double)proto->ops * threads / elapsed / 1e6;
+}
+
+int main(int argc, char** argv) {
+    uint64_t keys = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+    uint64_t ops = argc > 2 ? strtoull(argv[2], NULL, 10) : 2000000;
+    unsigned writePercent = argc > 3 ? (unsigned)atoi(argv[3]) : 10;
+
+    ConcurrentMap cmap = concurrentMapCreate(sizeof(uint64_t), sizeof(uint64_t), 0);
+    HashMap map = mapCreate(sizeof(uint64_t), sizeof(uint64_t), keys);
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    for (uint64_t k = 0; k < keys; k += 2) {
+        concurrentMapPut(cmap, &k, &k);
+        mapPut(map, &k, &k);
+    }
+
+    BenchWorker proto = { cmap, map, &lock, keys, ops, writePercent, 42, 0 };
+    printf("keys %llu, %llu ops/thread, %u%% writes\n", (unsigned long long)keys, (unsigned long long)ops, writePercent);
+    printf("threads  ConcurrentMap Mops/s  mutex+HashMap Mops/s\n");
+    for (int threads = 1; threads <= BENCH_MAX_THREADS; threads *= 2) {
+        double c = _run(_concurrentWorker, &proto, threads);
+        double m = _run(_mutexWorker, &proto, threads);
+        printf("%7d  %20.2f  %20.2f\n", threads, c, m);
+    }
+
+    concurrentMapFree(cmap);
+    mapFree(map, NULL, NULL);
+    return 0;
+}
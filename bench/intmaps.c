@@ -0,0 +1,132 @@
+/*
+ * IntMap and U64Map, with and without an empty-key sentinel, against the
+ * generic HashMap created with mapCreate(sizeof(key), sizeof(int), 0): put
+ * of every key, lookups that hit and lookups that miss, on shuffled keys.
+ * Build from the repository root:
+ *
+ *   gcc -O2 -pthread bench/intmaps.c src/intmaps.c src/maps.c src/epochs.c \
+ *       src/arrays.c src/strings.c src/pointers.c -Iinclude -lm -o bin/bench_intmaps
+ *
+ * Usage: bench_intmaps [keys] [lookups]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "../include/intmaps.h"
+#include "../include/maps.h"
+
+typedef struct {
+    double put;
+    double hit;
+    double miss;
+    size_t found;
+} BenchResult;
+
+static double _now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static inline uint64_t _next(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+#define BENCH_INTMAP(Name, prefix, KeyType)                                                 \
+    static BenchResult _bench##Name(const KeyType* keys, int n, const KeyType* hits,     \
+                                       const KeyType* misses, int lookups, bool sentinel) { \
+        BenchResult r = { 0, 0, 0, 0 };                                                     \
+        double start = _now();                                                              \
+        Name map = sentinel                                                                 \
+            ? prefix##CreateSentinel(sizeof(int), 0, (KeyType)-1)                           \
+            : prefix##Create(sizeof(int), 0);                                               \
+        for (int i = 0; i < n; i++) prefix##Put(map, keys[i], &i);                          \
+        r.put = (_now() - start) * 1e9 / n;                                                 \
+        start = _now();                                                                     \
+        for (int i = 0; i < lookups; i++) r.found += prefix##Get(map, hits[i]) != NULL;     \
+        r.hit = (_now() - start) * 1e9 / lookups;                                           \
+        start = _now();                                                                     \
+        for (int i = 0; i < lookups; i++) r.found += prefix##Get(map, misses[i]) != NULL;   \
+        r.miss = (_now() - start) * 1e9 / lookups;                                          \
+        prefix##Free(map);                                                                  \
+        return r;                                                                           \
+    }
+
+BENCH_INTMAP(IntMap, intMap, int)
+BENCH_INTMAP(U64Map, u64Map, uint64_t)
+
+static BenchResult _benchHashMap(const void* keys, size_t keySize, int n, const void* hits,
+                                 const void* misses, int lookups) {
+    BenchResult r = { 0, 0, 0, 0 };
+    const char* k = (const char*)keys;
+    const char* h = (const char*)hits;
+    const char* m = (const char*)misses;
+    double start = _now();
+    HashMap map = mapCreate(keySize, sizeof(int), 0);
+    for (int i = 0; i < n; i++) mapPut(map, (void*)(k + (size_t)i * keySize), &i);
+    r.put = (_now() - start) * 1e9 / n;
+    start = _now();
+    for (int i = 0; i < lookups; i++) r.found += mapGet(map, (void*)(h + (size_t)i * keySize)) != NULL;
+    r.hit = (_now() - start) * 1e9 / lookups;
+    start = _now();
+    for (int i = 0; i < lookups; i++) r.found += mapGet(map, (void*)(m + (size_t)i * keySize)) != NULL;
+    r.miss = (_now() - start) * 1e9 / lookups;
+    mapFree(map, NULL, NULL);
+    return r;
+}
+
+static void _print(const char* name, BenchResult r, int lookups) {
+    printf("%-22s %8.1f %8.1f %8.1f\n", name, r.put, r.hit, r.miss);
+    if (r.found != (size_t)lookups) fprintf(stderr, "%s: %zu lookups found, expected %d\n", name, r.found, lookups);
+}
+
+int main(int argc, char** argv) {
+    int keys = argc > 1 ? atoi(argv[1]) : 1000000;
+    int lookups = argc > 2 ? atoi(argv[2]) : 5000000;
+    if (keys < 1 || lookups < 1) return 1;
+
+    uint64_t state = 88172645463325252ULL;
+    uint64_t* keys64 = (uint64_t*)malloc((size_t)keys * sizeof(uint64_t));
+    uint64_t* hits64 = (uint64_t*)malloc((size_t)lookups * sizeof(uint64_t));
+    uint64_t* misses64 = (uint64_t*)malloc((size_t)lookups * sizeof(uint64_t));
+    int* keys32 = (int*)malloc((size_t)keys * sizeof(int));
+    int* hits32 = (int*)malloc((size_t)lookups * sizeof(int));
+    int* misses32 = (int*)malloc((size_t)lookups * sizeof(int));
+    for (int i = 0; i < keys; i++) keys64[i] = (uint64_t)i * 2;
+    for (int i = keys - 1; i > 0; i--) {
+        int j = (int)(_next(&state) % (uint64_t)(i + 1));
+        uint64_t tmp = keys64[i];
+        keys64[i] = keys64[j];
+        keys64[j] = tmp;
+    }
+    for (int i = 0; i < lookups; i++) {
+        hits64[i] = keys64[_next(&state) % (uint64_t)keys];
+        misses64[i] = hits64[i] + 1;
+    }
+    for (int i = 0; i < keys; i++) keys32[i] = (int)keys64[i];
+    for (int i = 0; i < lookups; i++) {
+        hits32[i] = (int)hits64[i];
+        misses32[i] = (int)misses64[i];
+    }
+
+    printf("keys %d, %d lookups, ns/op\n", keys, lookups);
+    printf("%-22s %8s %8s %8s\n", "", "put", "hit", "miss");
+    _print("HashMap<int>", _benchHashMap(keys32, sizeof(int), keys, hits32, misses32, lookups), lookups);
+    _print("IntMap", _benchIntMap(keys32, keys, hits32, misses32, lookups, false), lookups);
+    _print("IntMap sentinel", _benchIntMap(keys32, keys, hits32, misses32, lookups, true), lookups);
+    _print("HashMap<uint64_t>", _benchHashMap(keys64, sizeof(uint64_t), keys, hits64, misses64, lookups), lookups);
+    _print("U64Map", _benchU64Map(keys64, keys, hits64, misses64, lookups, false), lookups);
+    _print("U64Map sentinel", _benchU64Map(keys64, keys, hits64, misses64, lookups, true), lookups);
+
+    free(keys64);
+    free(hits64);
+    free(misses64);
+    free(keys32);
+    free(hits32);
+    free(misses32);
+    return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * SkipList against a Tree behind one global mutex: 1/2/4/8/16 reader threads
+ * doing lookups while a single ingest thread inserts and removes keys, the
+ * shape of the web index workload. Build from the repository root:
+ *
+ *   gcc -O2 -pthread bench/skiplists.c src/skiplists.c src/epochs.c src/tree.c \
+ *       src/arrays.c src/strings.c src/pointers.c -Iinclude -lm -o bin/bench_skiplists
+ *
+ * Usage: bench_skiplists [keys] [seconds]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include "../include/skiplists.h"
+#include "../include/trees.h"
+#include "../include/arrays.h"
+
+#define BENCH_MAX_READERS 16
+
+typedef struct {
+    SkipList sl;
+    Tree tree;
+    pthread_mutex_t lock;
+    int keys;
+    atomic_bool stop;
+} BenchShared;
+
+typedef struct {
+    BenchShared* shared;
+    uint64_t seed;
+    uint64_t ops;
+} BenchWorker;
+
+static double _now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static inline int _nextKey(uint64_t* state, int keys) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return (int)(*state % (uint64_t)keys);
+}
+
+static void* _skipReader(void* arg) {
+    BenchWorker* w = (BenchWorker*)arg;
+    BenchShared* s = w->shared;
+    while (!atomic_load_explicit(&s->stop, memory_order_relaxed)) {
+        int key = _nextKey(&w->seed, s->keys);
+        int out;
+        skipListGet(s->sl, &key, &out);
+        w->ops++;
+    }
+    return NULL;
+}
+
+static void* _skipWriter(void* arg) {
+    BenchWorker* w = (BenchWorker*)arg;
+    BenchShared* s = w->shared;
+    while (!atomic_load_explicit(&s->stop, memory_order_relaxed)) {
+        int key = _nextKey(&w->seed, s->keys);
+        if (w->ops & 1) skipListRemove(s->sl, &key);
+        else skipListInsert(s->sl, &key);
+        w->ops++;
+    }
+    return NULL;
+}
+
+static void* _treeReader(void* arg) {
+    BenchWorker* w = (BenchWorker*)arg;
+    BenchShared* s = w->shared;
+    while (!atomic_load_explicit(&s->stop, memory_order_relaxed)) {
+        int key = _nextKey(&w->seed, s->keys);
+        int out;
+        pthread_mutex_lock(&s->lock);
+        int* found = (int*)treeSearch(s->tree, &key);
+        if (found) out = *found;
+        pthread_mutex_unlock(&s->lock);
+        (void)out;
+        w->ops++;
+    }
+    return NULL;
+}
+
+static void* _treeWriter(void* arg) {
+    BenchWorker* w = (BenchWorker*)arg;
+    BenchShared* s = w->shared;
+    while (!atomic_load_explicit(&s->stop, memory_order_relaxed)) {
+        int key = _nextKey(&w->seed, s->keys);
+        pthread_mutex_lock(&s->lock);
+        if (w->ops & 1) treeRemove(s->tree, &key, NULL);
+        else treeInsert(s->tree, &key);
+        pthread_mutex_unlock(&s->lock);
+        w->ops++;
+    }
+    return NULL;
+}
+
+static void _run(BenchShared* s, void* (*reader)(void*), void* (*writer)(void*), int readers, double seconds, double* readRate, double* writeRate) {
+    pthread_t tids[BENCH_MAX_READERS + 1];
+    BenchWorker workers[BENCH_MAX_READERS + 1];
+    atomic_store(&s->stop, false);
+    for (int i = 0; i <= readers; i++) {
+        workers[i].shared = s;
+        workers[i].seed = 0x9E3779B97F4A7C15ULL * (uint64_t)(i + 1);
+        workers[i].ops = 0;
+        pthread_create(&tids[i], NULL, i == readers ? writer : reader, &workers[i]);
+    }
+
+    double start = _now();
+    struct timespec pause = { (time_t)seconds, (long)((seconds - (double)(time_t)seconds) * 1e9) };
+    nanosleep(&pause, NULL);
+    atomic_store(&s->stop, true);
+    for (int i = 0; i <= readers; i++) pthread_join(tids[i], NULL);
+    double elapsed = _now() - start;
+
+    uint64_t reads = 0;
+    for (int i = 0; i < readers; i++) reads += workers[i].ops;
+    *readRate = (double)reads / elapsed / 1e6;
+    *writeRate = (double)workers[readers].ops / elapsed / 1e6;
+}
+
+int main(int argc, char** argv) {
+    int keys = argc > 1 ? atoi(argv[1]) : 1000000;
+    double seconds = argc > 2 ? atof(argv[2]) : 1.0;
+
+    BenchShared s;
+    s.sl = skipListCreate(sizeof(int), SORT_INT_ASC);
+    s.tree = treeCreate(sizeof(int), SORT_INT_ASC);
+    s.keys = keys;
+    pthread_mutex_init(&s.lock, NULL);
+    for (int k = 0; k < keys; k += 2) {
+        skipListInsert(s.sl, &k);
+        treeInsert(s.tree, &k);
+    }
+
+    printf("keys %d, %.1fs per run, 1 ingest thread\n", keys, seconds);
+    printf("readers  SkipList reads  writes   mutex+Tree reads  writes  (Mops/s)\n");
+    for (int readers = 1; readers <= BENCH_MAX_READERS; readers *= 2) {
+        double sr, sw, tr, tw;
+        _run(&s, _skipReader, _skipWriter, readers, seconds, &sr, &sw);
+        _run(&s, _treeReader, _treeWriter, readers, seconds, &tr, &tw);
+        printf("%7d  %14.2f  %6.2f  %16.2f  %6.2f\n", readers, sr, sw, tr, tw);
+    }
+
+    skipListFree(s.sl, NULL);
+    treeFree(s.tree, NULL);
+    pthread_mutex_destroy(&s.lock);
+    return 0;
+}
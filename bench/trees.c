@@ -0,0 +1,141 @@
+/*
+ * Tree engines by insertion order and under Zipf-skewed lookups. The first
+ * table inserts the same keys sorted and shuffled into each engine and
+ * times the inserts and one search per key. The second queries a shuffled
+ * key set with a Zipf(s) stream whose hot keys are a second random
+ * permutation, so popularity is unrelated to insertion order. Build from
+ * the repository root:
+ *
+ *   gcc -O2 bench/trees.c src/tree.c src/arrays.c src/strings.c src/pointers.c \
+ *       -Iinclude -lm -o bin/bench_trees
+ *
+ * Usage: bench_trees [keys] [lookups] [insertKeys]
+ *
+ * insertKeys defaults to 20000 because sorted inserts into the plain BST
+ * are quadratic.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "../include/trees.h"
+
+#define BENCH_ENGINES 4
+
+static const char* _engineNames[BENCH_ENGINES] = { "AVL", "BST", "splay", "treap" };
+static const double _skews[] = { 0.8, 1.0, 1.1, 1.3 };
+
+static double _now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static inline uint64_t _next(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void _shuffle(int* keys, int n, uint64_t* state) {
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int)(_next(state) % (uint64_t)(i + 1));
+        int tmp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+}
+
+static void _zipfCdf(double* cdf, int n, double s) {
+    double sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += 1.0 / pow((double)(i + 1), s);
+        cdf[i] = sum;
+    }
+    for (int i = 0; i < n; i++) cdf[i] /= sum;
+}
+
+static int _zipfRank(const double* cdf, int n, uint64_t* state) {
+    double u = (double)(_next(state) >> 11) * (1.0 / 9007199254740992.0);
+    int lo = 0, hi = n - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (cdf[mid] < u) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static void _insertOrder(const char* label, const int* keys, int n) {
+    for (int e = 0; e < BENCH_ENGINES; e++) {
+        Tree t = treeCreateWithEngine(sizeof(int), SORT_INT_ASC, (TreeEngine)e);
+        double start = _now();
+        for (int i = 0; i < n; i++) treeInsert(t, (void*)&keys[i]);
+        double inserted = _now();
+        size_t hits = 0;
+        for (int i = 0; i < n; i++) hits += treeSearch(t, (void*)&keys[i]) != NULL;
+        double searched = _now();
+        if (hits != (size_t)n) fprintf(stderr, "%s: %zu of %d keys missing\n", _engineNames[e], (size_t)n - hits, n);
+        printf("%-8s  %-5s  %12.1f  %12.1f  %7zu\n", label, _engineNames[e], (inserted - start) * 1e9 / n,
+               (searched - inserted) * 1e9 / n, treeHeight(t));
+        treeFree(t, NULL);
+    }
+}
+
+int main(int argc, char** argv) {
+    int keys = argc > 1 ? atoi(argv[1]) : 200000;
+    int lookups = argc > 2 ? atoi(argv[2]) : 5000000;
+    int insertKeys = argc > 3 ? atoi(argv[3]) : 20000;
+    if (keys < 1 || lookups < 1 || insertKeys < 1) return 1;
+
+    uint64_t state = 88172645463325252ULL;
+    int* order = (int*)malloc((size_t)keys * sizeof(int));
+    int* hot = (int*)malloc((size_t)keys * sizeof(int));
+    double* cdf = (double*)malloc((size_t)keys * sizeof(double));
+    int* queries = (int*)malloc((size_t)lookups * sizeof(int));
+    for (int i = 0; i < keys; i++) order[i] = hot[i] = i * 3;
+
+    int* inserts = (int*)malloc((size_t)insertKeys * sizeof(int));
+    for (int i = 0; i < insertKeys; i++) inserts[i] = i;
+    printf("keys %d, ns/insert and ns/search per key\n", insertKeys);
+    printf("order     engine       insert        search   height\n");
+    _insertOrder("sorted", inserts, insertKeys);
+    _shuffle(inserts, insertKeys, &state);
+    _insertOrder("shuffled", inserts, insertKeys);
+    free(inserts);
+    printf("\n");
+
+    _shuffle(order, keys, &state);
+    _shuffle(hot, keys, &state);
+
+    printf("keys %d, %d lookups, ns/lookup (final height)\n", keys, lookups);
+    printf("    s");
+    for (int e = 0; e < BENCH_ENGINES; e++) printf("  %14s", _engineNames[e]);
+    printf("\n");
+    for (size_t k = 0; k < sizeof(_skews) / sizeof(_skews[0]); k++) {
+        _zipfCdf(cdf, keys, _skews[k]);
+        for (int i = 0; i < lookups; i++) queries[i] = hot[_zipfRank(cdf, keys, &state)];
+
+        printf("%5.2f", _skews[k]);
+        for (int e = 0; e < BENCH_ENGINES; e++) {
+            Tree t = treeCreateWithEngine(sizeof(int), SORT_INT_ASC, (TreeEngine)e);
+            for (int i = 0; i < keys; i++) treeInsert(t, &order[i]);
+            size_t hits = 0;
+            double start = _now();
+            for (int i = 0; i < lookups; i++) hits += treeSearch(t, &queries[i]) != NULL;
+            double elapsed = _now() - start;
+            if (hits != (size_t)lookups) fprintf(stderr, "%s: %zu of %d lookups missed\n", _engineNames[e], (size_t)lookups - hits, lookups);
+            printf("  %7.1f (%4zu)", elapsed * 1e9 / lookups, treeHeight(t));
+            treeFree(t, NULL);
+        }
+        printf("\n");
+    }
+
+    free(order);
+    free(hot);
+    free(cdf);
+    free(queries);
+    return 0;
+}
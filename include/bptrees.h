@@ -0,0 +1,65 @@
+#ifndef BPTREES_H
+#define BPTREES_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "../include/arrays.h"
+
+#ifndef BPTREE_LEAF_BYTES
+#define BPTREE_LEAF_BYTES  4096
+#endif
+
+#ifndef BPTREE_INNER_BYTES
+#define BPTREE_INNER_BYTES 1024
+#endif
+
+typedef struct BPTreeNode {
+    struct BPTreeNode* next;
+    struct BPTreeNode* previous;
+    uint32_t count;
+    bool leaf;
+    uint64_t data[];
+} BPTreeNode;
+
+typedef struct {
+    BPTreeNode* root;
+    size_t esize;
+    size_t count;
+    size_t height;
+    size_t leafCapacity;
+    size_t innerCapacity;
+    size_t childOffset;
+    bool intKeys;
+    void* scratch;
+    int (*cmp)(const void*, const void*);
+} BPTreeStruct;
+
+typedef BPTreeStruct* BPTree;
+
+typedef struct {
+    BPTree tree;
+    BPTreeNode* leaf;
+    size_t index;
+} BPTreeIterator;
+
+BPTree bpTreeCreate(size_t esize, int (*cmp)(const void*, const void*));
+BPTree bpTreeFromSortedArray(Array arr, int (*cmp)(const void*, const void*));
+
+void bpTreeInsert(BPTree t, void* data);
+bool bpTreeContains(BPTree t, void* data);
+void* bpTreeSearch(BPTree t, void* data);
+void bpTreeRemove(BPTree t, void* data, void (*freeFn)(void*));
+void bpTreeClear(BPTree t, void (*freeFn)(void*));
+void bpTreeFree(BPTree t, void (*freeFn)(void*));
+
+size_t bpTreeSize(BPTree t);
+void* bpTreeMin(BPTree t);
+void* bpTreeMax(BPTree t);
+
+BPTreeIterator bpTreeSeek(BPTree t, void* lo);
+void* bpTreeNext(BPTreeIterator* it);
+size_t bpTreeRange(BPTree t, void* lo, void* hi, bool (*fn)(void* data, void* ctx), void* ctx);
+Array bpTreeToArray(BPTree t);
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef CACHES_H
+#define CACHES_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "maps.h"
+
+typedef enum {
+    CACHE_EVICT_CAPACITY,
+    CACHE_EVICT_EXPIRED,
+    CACHE_EVICT_REPLACED,
+    CACHE_EVICT_REMOVED
+} CacheEvictReason;
+
+typedef struct CacheEntry {
+    struct CacheEntry* previous;
+    struct CacheEntry* next;
+    uint64_t expiresAt;
+    size_t bytes;
+    size_t keyLen;
+    _Alignas(max_align_t) char data[];
+} CacheEntry;
+
+typedef struct {
+    size_t maxEntries;
+    size_t maxBytes;
+    uint64_t ttlMs;
+    void (*onEvict)(void* key, void* value, CacheEvictReason reason, void* ctx);
+    void* ctx;
+} CacheOptions;
+
+typedef struct {
+    HashMap map;
+    CacheEntry* head;
+    CacheEntry* tail;
+    size_t keySize;
+    size_t valueSize;
+    size_t count;
+    size_t bytes;
+    CacheOptions opts;
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t expirations;
+} CacheStruct;
+
+typedef CacheStruct* Cache;
+
+Cache cacheCreate(size_t keySize, size_t valueSize, CacheOptions opts);
+Cache cacheCreateStr(size_t valueSize, CacheOptions opts);
+void cachePut(Cache cache, void* key, void* value);
+void cachePutEx(Cache cache, void* key, void* value, size_t bytes, uint64_t ttlMs);
+void* cacheGet(Cache cache, void* key);
+bool cacheContains(Cache cache, void* key);
+void cacheRemove(Cache cache, void* key);
+void cachePutStr(Cache cache, const char* key, size_t len, void* value);
+void* cacheGetStr(Cache cache, const char* key, size_t len);
+void cacheRemoveStr(Cache cache, const char* key, size_t len);
+size_t cachePurgeExpired(Cache cache);
+void cacheClear(Cache cache);
+void cacheFree(Cache cache);
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef EPOCHS_H
+#define EPOCHS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+typedef struct EpochRetired {
+    struct EpochRetired* next;
+    uint64_t epoch;
+    void* ptr;
+    void (*freeFn)(void*);
+} EpochRetired;
+
+typedef struct {
+    _Atomic(EpochRetired*) head;
+} EpochList;
+
+void epochEnter(void);
+void epochExit(void);
+void epochListInit(EpochList* list);
+void epochRetire(EpochList* list, void* ptr, void (*freeFn)(void*));
+size_t epochReclaim(EpochList* list);
+void epochDrain(EpochList* list);
+
+#endif
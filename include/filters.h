@@ -0,0 +1,51 @@
+#ifndef FILTERS_H
+#define FILTERS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "arrays.h"
+
+typedef struct {
+    uint32_t* blocks;
+    void* memory;
+    size_t blockCount;
+    size_t keySize;
+    size_t count;
+    uint64_t seed;
+} BloomFilterStruct;
+
+typedef BloomFilterStruct* BloomFilter;
+
+typedef struct {
+    uint8_t* table;
+    size_t bucketCount;
+    size_t fingerprintBytes;
+    size_t keySize;
+    size_t count;
+    uint64_t seed;
+    bool hasVictim;
+    size_t victimIndex;
+    uint16_t victimFingerprint;
+} CuckooFilterStruct;
+
+typedef CuckooFilterStruct* CuckooFilter;
+
+BloomFilter bloomFilterCreate(size_t keySize, size_t expected, double fpr);
+BloomFilter bloomFilterFromArray(Array arr, double fpr);
+void bloomFilterAdd(BloomFilter filter, void* key);
+bool bloomFilterContains(BloomFilter filter, void* key);
+bool bloomFilterSave(BloomFilter filter, const char* path);
+BloomFilter bloomFilterLoad(const char* path);
+void bloomFilterFree(BloomFilter filter);
+
+CuckooFilter cuckooFilterCreate(size_t keySize, size_t expected, double fpr);
+CuckooFilter cuckooFilterFromArray(Array arr, double fpr);
+bool cuckooFilterAdd(CuckooFilter filter, void* key);
+bool cuckooFilterContains(CuckooFilter filter, void* key);
+bool cuckooFilterRemove(CuckooFilter filter, void* key);
+bool cuckooFilterSave(CuckooFilter filter, const char* path);
+CuckooFilter cuckooFilterLoad(const char* path);
+void cuckooFilterFree(CuckooFilter filter);
+
+#endif
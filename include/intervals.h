@@ -0,0 +1,46 @@
+#ifndef INTERVALS_H
+#define INTERVALS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "../include/arrays.h"
+
+typedef struct IntervalNode {
+    int64_t start;
+    int64_t end;
+    int64_t maxEnd;
+    struct IntervalNode* left;
+    struct IntervalNode* right;
+    int height;
+    max_align_t value[];
+} IntervalNode;
+
+typedef struct {
+    int64_t start;
+    int64_t end;
+    void* value;
+} Interval;
+
+typedef struct {
+    IntervalNode* root;
+    size_t valueSize;
+    size_t count;
+} IntervalTreeStruct;
+
+typedef IntervalTreeStruct* IntervalTree;
+
+IntervalTree intervalTreeCreate(size_t valueSize);
+
+void intervalTreeInsert(IntervalTree t, int64_t start, int64_t end, void* value);
+bool intervalTreeRemove(IntervalTree t, int64_t start, int64_t end, void* value, void (*valFree)(void*));
+size_t intervalTreeStab(IntervalTree t, int64_t point, bool (*fn)(const Interval* iv, void* ctx), void* ctx);
+size_t intervalTreeOverlap(IntervalTree t, int64_t start, int64_t end, bool (*fn)(const Interval* iv, void* ctx), void* ctx);
+size_t intervalTreeStabInto(IntervalTree t, int64_t point, Array out);
+size_t intervalTreeOverlapInto(IntervalTree t, int64_t start, int64_t end, Array out);
+
+size_t intervalTreeSize(IntervalTree t);
+void intervalTreeClear(IntervalTree t, void (*valFree)(void*));
+void intervalTreeFree(IntervalTree t, void (*valFree)(void*));
+
+#endif
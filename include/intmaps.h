@@ -0,0 +1,45 @@
+#ifndef INTMAPS_H
+#define INTMAPS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define INTMAP_DECLARE(Name, prefix, KeyType)                                          \
+    typedef struct {                                                                   \
+        KeyType* keys;                                                                 \
+        uint8_t* used;                                                                 \
+        uint8_t* values;                                                               \
+        size_t capacity;                                                               \
+        size_t count;                                                                  \
+        size_t valueSize;                                                              \
+        unsigned shift;                                                                \
+        uint64_t seed;                                                                 \
+        bool sentinel;                                                                 \
+        bool hasEmptyKey;                                                              \
+        KeyType emptyKey;                                                              \
+    } Name##Struct;                                                                    \
+                                                                                       \
+    typedef Name##Struct* Name;                                                        \
+                                                                                       \
+    typedef struct {                                                                   \
+        Name map;                                                                      \
+        size_t index;                                                                  \
+    } Name##Iterator;                                                                  \
+                                                                                       \
+    Name prefix##Create(size_t valueSize, size_t capacity);                            \
+    Name prefix##CreateSentinel(size_t valueSize, size_t capacity, KeyType emptyKey);  \
+    void prefix##Put(Name map, KeyType key, void* value);                              \
+    void* prefix##Get(Name map, KeyType key);                                          \
+    bool prefix##Contains(Name map, KeyType key);                                      \
+    void prefix##Remove(Name map, KeyType key);                                        \
+    void prefix##Reserve(Name map, size_t n);                                          \
+    void prefix##Clear(Name map);                                                      \
+    void prefix##Free(Name map);                                                       \
+    Name##Iterator prefix##Iterator(Name map);                                         \
+    bool prefix##Next(Name##Iterator* it, KeyType* key, void** value);
+
+INTMAP_DECLARE(IntMap, intMap, int)
+INTMAP_DECLARE(U64Map, u64Map, uint64_t)
+
+#endif
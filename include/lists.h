@@ -7,12 +7,14 @@
 typedef struct SLinkedListNode{
     void* data;
     struct SLinkedListNode* next;
+    max_align_t storage[];
 } SLinkedListNode;
 
 typedef struct DLinkedListNode{
     void* data;
     struct DLinkedListNode* next;
     struct DLinkedListNode* previous;
+    max_align_t storage[];
 } DLinkedListNode;
 
 typedef struct {
@@ -4,33 +4,119 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
 #include "arrays.h" 
+#include "epochs.h"
 
 typedef struct MapEntry {
     void* key;
     void* value;
     struct MapEntry* next;
+    size_t order;
 } MapEntry;
 
+/*
+ * MAP_ENGINE_CHAINED keeps every key and value in its own allocation: pointers
+ * returned by mapGet, mapGetKey, mapGetStr and setGet stay valid until that key
+ * is removed, and mapPut(map, key, NULL) stores no value (mapGet returns NULL).
+ *
+ * MAP_ENGINE_SWISS stores keys and values inline in one array. Any mapPut that
+ * inserts a new key, and mapReserve, may move that array, so returned pointers
+ * are only valid until the next insertion. mapPut(map, key, NULL) stores a
+ * zeroed value. Opt in with mapCreateWithEngine, mapCreateStrWithEngine
+ * or -DMAP_DEFAULT_ENGINE.
+ */
+typedef enum {
+    MAP_ENGINE_CHAINED,
+    MAP_ENGINE_SWISS
+} MapEngine;
+
+#ifndef MAP_DEFAULT_ENGINE
+#define MAP_DEFAULT_ENGINE MAP_ENGINE_CHAINED
+#endif
+
 typedef struct {
+    MapEngine engine;
     MapEntry** buckets;     
     size_t capacity;        
     size_t count;           
     size_t keySize;         
     size_t valueSize;       
-    uint32_t (*hashFunc)(const void* key, size_t size);
+    uint64_t (*hashFunc)(const void* key, size_t size, uint64_t seed);
     bool (*keyEquals)(const void* key1, const void* key2, size_t size);
+    uint64_t seed;
+    bool strKeys;
+    MapEntry** oldBuckets;
+    size_t oldCapacity;
+    size_t rehashIndex;
+    uint8_t* ctrl;
+    uint32_t* index;
+    uint8_t* entries;
+    MapEntry** order;
+    size_t entryCount;
+    size_t entryCapacity;
+    size_t entrySize;
+    size_t valueOffset;
+    size_t growthLeft;
+    uint64_t probes;
+    uint64_t lookups;
+    uint64_t maxLookupProbes;
 } HashMapStruct;
 
 typedef HashMapStruct* HashMap;
 
+typedef struct {
+    HashMap map;
+    size_t index;
+} MapIterator;
+
+#define MAP_STATS_HISTOGRAM 16
+
+typedef struct {
+    size_t count;
+    size_t capacity;
+    double loadFactor;
+    size_t emptyBuckets;
+    size_t deletedSlots;
+    size_t collisions;
+    size_t maxProbe;
+    double averageProbe;
+    size_t probeHistogram[MAP_STATS_HISTOGRAM];
+    size_t bytes;
+    uint64_t probes;
+    uint64_t lookups;
+    uint64_t maxLookupProbes;
+} MapStats;
+
 typedef struct {
     HashMap map;
 } SetStruct;
 
 typedef SetStruct* Set;
 
+typedef struct {
+    pthread_mutex_t lock;
+    atomic_uint_fast64_t seq;
+    _Atomic(HashMap) map;
+    EpochList retired;
+    char pad[64];
+} ConcurrentShard;
+
+typedef struct {
+    ConcurrentShard* shards;
+    size_t shardCount;
+    size_t keySize;
+    size_t valueSize;
+    uint64_t seed;
+} ConcurrentMapStruct;
+
+typedef ConcurrentMapStruct* ConcurrentMap;
+
 HashMap mapCreate(size_t keySize, size_t valueSize, size_t capacity);
+HashMap mapCreateWithEngine(size_t keySize, size_t valueSize, size_t capacity, MapEngine engine);
+HashMap mapCreateStr(size_t valueSize, size_t capacity);
+HashMap mapCreateStrWithEngine(size_t valueSize, size_t capacity, MapEngine engine);
 void mapPut(HashMap map, void* key, void* value);
 void* mapGet(HashMap map, void* key);
 bool mapContains(HashMap map, void* key);
@@ -38,9 +124,24 @@ void mapRemove(HashMap map, void* key, void (*keyFree)(void*), void (*valFree)(v
 void mapClear(HashMap map, void (*keyFree)(void*), void (*valFree)(void*));
 void mapFree(HashMap map, void (*keyFree)(void*), void (*valFree)(void*));
 void* mapGetKey(HashMap map, void* key);
+void mapPutStr(HashMap map, const char* key, size_t len, void* value);
+void* mapGetStr(HashMap map, const char* key, size_t len);
+bool mapContainsStr(HashMap map, const char* key, size_t len);
+void mapRemoveStr(HashMap map, const char* key, size_t len, void (*valFree)(void*));
+size_t mapGetBatch(HashMap map, const void* keys, size_t n, void** outValues);
+size_t mapKeyLength(HashMap map, const void* key);
+void mapReserve(HashMap map, size_t n);
+void mapRehashFinish(HashMap map);
+MapIterator mapIterator(HashMap map);
+bool mapNext(MapIterator* it, void** key, void** value);
+void mapForEach(HashMap map, void (*fn)(void* key, void* value, void* ctx), void* ctx);
+bool mapStats(HashMap map, MapStats* out);
+void mapResetProbeStats(HashMap map);
 
-uint32_t hashInt(const void* key, size_t size);
-uint32_t hashString(const void* key, size_t size);
+uint64_t hashSeed(void);
+uint64_t hashBytes(const void* data, size_t len, uint64_t seed);
+uint64_t hashInt(const void* key, size_t size, uint64_t seed);
+uint64_t hashString(const void* key, size_t size, uint64_t seed);
 bool keyEqualsInt(const void* k1, const void* k2, size_t size);
 bool keyEqualsString(const void* k1, const void* k2, size_t size);
 
@@ -49,8 +150,28 @@ Set setFromArray(Array arr);
 void setAdd(Set set, void* key);
 void setRemove(Set set, void* key, void (*freeFn)(void*));
 bool setContains(Set set, void* key);
+size_t setContainsBatch(Set set, const void* keys, size_t n, bool* out);
 void setFree(Set set, void (*freeFn)(void*));
 void* setGet(Set set, void* key);
 Array setToArray(Set set);
+size_t setSize(Set set);
+Set setUnion(Set a, Set b);
+Set setIntersect(Set a, Set b);
+Set setDifference(Set a, Set b);
+void setUnionInPlace(Set a, Set b);
+void setIntersectInPlace(Set a, Set b);
+void setDifferenceInPlace(Set a, Set b);
+bool setIsSubset(Set a, Set b);
+double setJaccard(Set a, Set b);
+
+ConcurrentMap concurrentMapCreate(size_t keySize, size_t valueSize, size_t shards);
+void concurrentMapPut(ConcurrentMap cmap, void* key, void* value);
+bool concurrentMapGet(ConcurrentMap cmap, void* key, void* out);
+bool concurrentMapContains(ConcurrentMap cmap, void* key);
+void concurrentMapRemove(ConcurrentMap cmap, void* key);
+bool concurrentMapComputeIfAbsent(ConcurrentMap cmap, void* key, void (*fn)(const void* key, void* value, void* ctx), void* ctx, void* out);
+bool concurrentMapUpdate(ConcurrentMap cmap, void* key, void (*fn)(const void* key, void* value, void* ctx), void* ctx);
+size_t concurrentMapSize(ConcurrentMap cmap);
+void concurrentMapFree(ConcurrentMap cmap);
 
 #endif
\ No newline at end of file
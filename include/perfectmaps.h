@@ -0,0 +1,37 @@
+#ifndef PERFECTMAPS_H
+#define PERFECTMAPS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "arrays.h"
+
+typedef struct {
+    uint64_t seed;
+    uint32_t count;
+    uint32_t slotCount;
+    uint32_t bucketCount;
+    uint32_t keySize;
+    uint32_t valueSize;
+    const uint32_t* disp;
+    const uint32_t* offsets;
+    const uint8_t* used;
+    const uint8_t* keys;
+    const uint8_t* values;
+    void* memory;
+} PerfectMapStruct;
+
+typedef PerfectMapStruct* PerfectMap;
+
+PerfectMap perfectMapBuild(Array keys, Array values);
+PerfectMap perfectMapBuildStr(Array keys, Array values);
+void* perfectMapGet(PerfectMap map, const void* key);
+void* perfectMapGetStr(PerfectMap map, const char* key, size_t len);
+bool perfectMapContains(PerfectMap map, const void* key);
+bool perfectMapContainsStr(PerfectMap map, const char* key, size_t len);
+bool perfectMapSave(PerfectMap map, const char* path);
+PerfectMap perfectMapLoad(const char* path);
+bool perfectMapDumpHeader(PerfectMap map, const char* path, const char* name);
+void perfectMapFree(PerfectMap map);
+
+#endif
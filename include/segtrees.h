@@ -0,0 +1,56 @@
+#ifndef SEGTREES_H
+#define SEGTREES_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "../include/arrays.h"
+
+typedef struct {
+    double* tree;
+    size_t n;
+} FenwickTreeStruct;
+
+typedef FenwickTreeStruct* FenwickTree;
+
+typedef struct {
+    double (*combine)(double a, double b);
+    double identity;
+    double (*apply)(double aggregate, double delta, size_t len);
+} SegmentOp;
+
+typedef struct {
+    double* tree;
+    double* lazy;
+    size_t n;
+    int height;
+    SegmentOp op;
+} SegmentTreeStruct;
+
+typedef SegmentTreeStruct* SegmentTree;
+
+extern const SegmentOp SEGMENT_SUM;
+extern const SegmentOp SEGMENT_MIN;
+extern const SegmentOp SEGMENT_MAX;
+
+FenwickTree fenwickCreate(size_t n);
+FenwickTree fenwickFromArray(Array arr);
+FenwickTree fenwickFromIntArray(Array arr);
+void fenwickAdd(FenwickTree f, size_t index, double delta);
+void fenwickSet(FenwickTree f, size_t index, double value);
+double fenwickGet(FenwickTree f, size_t index);
+double fenwickPrefixSum(FenwickTree f, size_t end);
+double fenwickRangeSum(FenwickTree f, size_t start, size_t end);
+size_t fenwickSize(FenwickTree f);
+void fenwickFree(FenwickTree f);
+
+SegmentTree segmentTreeCreate(size_t n, SegmentOp op);
+SegmentTree segmentTreeFromArray(Array arr, SegmentOp op);
+SegmentTree segmentTreeFromIntArray(Array arr, SegmentOp op);
+void segmentTreeSet(SegmentTree st, size_t index, double value);
+double segmentTreeGet(SegmentTree st, size_t index);
+double segmentTreeQuery(SegmentTree st, size_t start, size_t end);
+void segmentTreeRangeAdd(SegmentTree st, size_t start, size_t end, double delta);
+size_t segmentTreeSize(SegmentTree st);
+void segmentTreeFree(SegmentTree st);
+
+#endif
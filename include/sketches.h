@@ -0,0 +1,79 @@
+#ifndef SKETCHES_H
+#define SKETCHES_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "arrays.h"
+#include "maps.h"
+
+typedef struct {
+    uint8_t precision;
+    bool sparse;
+    uint8_t* registers;
+    uint32_t* entries;
+    size_t entryCount;
+    size_t entryCapacity;
+    size_t sortedCount;
+    uint64_t seed;
+} HyperLogLogStruct;
+
+typedef HyperLogLogStruct* HyperLogLog;
+
+typedef struct {
+    uint64_t* counters;
+    size_t width;
+    size_t depth;
+    uint64_t total;
+    uint64_t seed;
+} CountMinSketchStruct;
+
+typedef CountMinSketchStruct* CountMinSketch;
+
+/* topKCreate and topKDeserialize reject larger k. */
+#define TOPK_MAX_K ((size_t)1 << 20)
+
+typedef struct {
+    char* key;
+    size_t len;
+    uint64_t count;
+    uint64_t error;
+} TopKItem;
+
+typedef struct {
+    TopKItem* items;
+    uint32_t* heap;
+    uint32_t* position;
+    size_t k;
+    size_t size;
+    HashMap index;
+} TopKStruct;
+
+typedef TopKStruct* TopK;
+
+HyperLogLog hllCreate(uint8_t precision);
+void hllAdd(HyperLogLog hll, const void* key, size_t len);
+void hllAddHash(HyperLogLog hll, uint64_t hash);
+uint64_t hllCount(HyperLogLog hll);
+bool hllMerge(HyperLogLog dest, HyperLogLog src);
+Array hllSerialize(HyperLogLog hll);
+HyperLogLog hllDeserialize(Array bytes);
+void hllFree(HyperLogLog hll);
+
+CountMinSketch countMinCreate(double epsilon, double delta);
+void countMinAdd(CountMinSketch cms, const void* key, size_t len, uint64_t count);
+uint64_t countMinEstimate(CountMinSketch cms, const void* key, size_t len);
+bool countMinMerge(CountMinSketch dest, CountMinSketch src);
+Array countMinSerialize(CountMinSketch cms);
+CountMinSketch countMinDeserialize(Array bytes);
+void countMinFree(CountMinSketch cms);
+
+TopK topKCreate(size_t k);
+void topKAdd(TopK topk, const void* key, size_t len, uint64_t count);
+Array topKList(TopK topk);
+bool topKMerge(TopK dest, TopK src);
+Array topKSerialize(TopK topk);
+TopK topKDeserialize(Array bytes);
+void topKFree(TopK topk);
+
+#endif
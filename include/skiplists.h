@@ -0,0 +1,39 @@
+#ifndef SKIPLISTS_H
+#define SKIPLISTS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "epochs.h"
+
+#define SKIPLIST_MAX_LEVEL 24
+
+typedef struct SkipListNode {
+    _Atomic(void*) data;
+    atomic_uint state;
+    uint32_t level;
+    _Atomic(uintptr_t) next[];
+} SkipListNode;
+
+typedef struct {
+    SkipListNode* head;
+    size_t esize;
+    atomic_size_t count;
+    EpochList retired;
+    int (*cmp)(const void*, const void*);
+} SkipListStruct;
+
+typedef SkipListStruct* SkipList;
+
+SkipList skipListCreate(size_t esize, int (*cmp)(const void*, const void*));
+
+void skipListInsert(SkipList sl, void* data);
+bool skipListGet(SkipList sl, void* key, void* out);
+bool skipListContains(SkipList sl, void* key);
+bool skipListRemove(SkipList sl, void* key);
+size_t skipListRange(SkipList sl, void* lo, void* hi, bool (*fn)(void* data, void* ctx), void* ctx);
+size_t skipListSize(SkipList sl);
+void skipListFree(SkipList sl, void (*freeFn)(void*));
+
+#endif
@@ -3,24 +3,53 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "../include/arrays.h"
 
 typedef struct TreeNode {
     void* data;
     struct TreeNode* left;
     struct TreeNode* right;
+    struct TreeNode* parent;
+    size_t size;
+    int height;
+    uint32_t priority;
+    max_align_t storage[];
 } TreeNode;
 
+typedef enum {
+    TREE_ENGINE_AVL,
+    TREE_ENGINE_BST,
+    TREE_ENGINE_SPLAY,
+    TREE_ENGINE_TREAP
+} TreeEngine;
+
+#ifndef TREE_DEFAULT_ENGINE
+#define TREE_DEFAULT_ENGINE TREE_ENGINE_AVL
+#endif
+
 typedef struct TreeStruct {
     TreeNode* root;
     size_t esize;
     size_t count;
+    TreeEngine engine;
     int (*cmp)(const void*, const void*);
+    void* slab;
+    size_t slabBytes;
+    size_t slabLive;
 } TreeStruct;
 
 typedef TreeStruct* Tree;
 
+typedef struct {
+    Tree tree;
+    TreeNode* node;
+} TreeIterator;
+
 Tree treeCreate(size_t esize, int (*cmp)(const void*, const void*));
+Tree treeCreateWithEngine(size_t esize, int (*cmp)(const void*, const void*), TreeEngine engine);
+Tree treeFromSortedArray(Array arr, int (*cmp)(const void*, const void*));
+Tree treeFromArray(Array arr, int (*cmp)(const void*, const void*));
 
 void treeInsert(Tree t, void* data);
 bool treeContains(Tree t, void* data);
@@ -28,6 +57,7 @@ void* treeSearch(Tree t, void* data);
 void treeRemove(Tree t, void* data, void (*freeFn)(void*));
 void treeClear(Tree t, void (*freeFn)(void*));
 void treeFree(Tree t, void (*freeFn)(void*));
+void treeFreeFast(Tree t);
 
 size_t treeSize(Tree t);
 size_t treeHeight(Tree t);
@@ -38,4 +68,17 @@ Array treeToInOrder(Tree t);
 Array treeToPreOrder(Tree t);
 Array treeToPostOrder(Tree t);
 
+void* treeFloor(Tree t, void* data);
+void* treeCeiling(Tree t, void* data);
+void* treeSelect(Tree t, size_t k);
+size_t treeRank(Tree t, void* data);
+
+TreeIterator treeIterator(Tree t);
+TreeIterator treeIteratorLast(Tree t);
+TreeIterator treeIterSeek(Tree t, void* lo);
+TreeIterator treeIterSeekLast(Tree t, void* hi);
+void* treeNext(TreeIterator* it);
+void* treePrev(TreeIterator* it);
+size_t treeRange(Tree t, void* lo, void* hi, bool (*fn)(void* data, void* ctx), void* ctx);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef TRIES_H
+#define TRIES_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TRIE_PREFIX_MAX 9
+
+typedef enum {
+    TRIE_NODE4,
+    TRIE_NODE16,
+    TRIE_NODE48,
+    TRIE_NODE256
+} TrieNodeType;
+
+typedef struct {
+    size_t keyLen;
+    max_align_t data[];
+} TrieLeaf;
+
+typedef struct {
+    uint32_t prefixLen;
+    uint16_t count;
+    uint8_t type;
+    uint8_t prefix[TRIE_PREFIX_MAX];
+    TrieLeaf* leaf;
+} TrieNode;
+
+typedef struct {
+    TrieNode header;
+    uint8_t keys[4];
+    void* children[4];
+} TrieNode4;
+
+typedef struct {
+    TrieNode header;
+    uint8_t keys[16];
+    void* children[16];
+} TrieNode16;
+
+typedef struct {
+    TrieNode header;
+    uint8_t index[256];
+    void* children[48];
+} TrieNode48;
+
+typedef struct {
+    TrieNode header;
+    void* children[256];
+} TrieNode256;
+
+typedef struct {
+    void* root;
+    size_t valueSize;
+    size_t count;
+} TrieStruct;
+
+typedef TrieStruct* Trie;
+
+Trie trieCreate(size_t valueSize);
+
+void triePut(Trie t, const char* key, size_t len, void* value);
+void* trieGet(Trie t, const char* key, size_t len);
+bool trieContains(Trie t, const char* key, size_t len);
+void trieRemove(Trie t, const char* key, size_t len, void (*valFree)(void*));
+void* trieLongestPrefix(Trie t, const char* key, size_t len, size_t* matchLen);
+size_t triePrefixForEach(Trie t, const char* prefix, size_t len, bool (*fn)(const char* key, size_t keyLen, void* value, void* ctx), void* ctx);
+
+size_t trieSize(Trie t);
+void trieClear(Trie t, void (*valFree)(void*));
+void trieFree(Trie t, void (*valFree)(void*));
+
+#endif
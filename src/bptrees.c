@@ -0,0 +1,435 @@
+#include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "../include/bptrees.h"
+#include "../include/pointers.h"
+
+#define BPTREE_MIN_FANOUT 4
+#define BPTREE_LINEAR     32
+
+static inline uint8_t* _key(BPTree t, BPTreeNode* n, size_t i) {
+    return (uint8_t*)n->data + i * t->esize;
+}
+
+static inline BPTreeNode** _children(BPTree t, BPTreeNode* n) {
+    return (BPTreeNode**)((uint8_t*)n->data + t->childOffset);
+}
+
+static BPTreeNode* _nodeNew(BPTree t, bool leaf) {
+    size_t bytes = leaf ? (t->leafCapacity + 1) * t->esize
+                        : t->childOffset + (t->innerCapacity + 2) * sizeof(BPTreeNode*);
+    BPTreeNode* n = (BPTreeNode*)xMalloc(sizeof(BPTreeNode) + bytes);
+    n->next = NULL;
+    n->previous = NULL;
+    n->count = 0;
+    n->leaf = leaf;
+    return n;
+}
+
+static size_t _intRank(const int* keys, size_t lo, size_t hi, int key, bool inclusive) {
+    while (hi - lo > BPTREE_LINEAR) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (keys[mid] < key || (inclusive && keys[mid] == key)) lo = mid + 1;
+        else hi = mid;
+    }
+    size_t i = lo;
+#ifdef __SSE2__
+    __m128i needle = _mm_set1_epi32(key);
+    for (; i + 4 <= hi; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(keys + i));
+        __m128i below = inclusive ? _mm_andnot_si128(_mm_cmpgt_epi32(v, needle), _mm_set1_epi32(-1))
+                                  : _mm_cmplt_epi32(v, needle);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(below));
+        if (mask != 0xF) return i + (size_t)__builtin_ctz(~mask & 0xF);
+    }
+#endif
+    for (; i < hi; i++)
+        if (!(keys[i] < key || (inclusive && keys[i] == key))) return i;
+    return hi;
+}
+
+static size_t _rank(BPTree t, BPTreeNode* n, const void* key, bool inclusive) {
+    if (t->intKeys) return _intRank((const int*)n->data, 0, n->count, *(const int*)key, inclusive);
+
+    size_t lo = 0, hi = n->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int r = t->cmp(_key(t, n, mid), key);
+        if (r < 0 || (inclusive && r == 0)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static BPTreeNode* _findLeaf(BPTree t, const void* key) {
+    BPTreeNode* n = t->root;
+    while (n && !n->leaf) n = _children(t, n)[_rank(t, n, key, true)];
+    return n;
+}
+
+BPTree bpTreeCreate(size_t esize, int (*cmp)(const void*, const void*)) {
+    BPTree t = (BPTree)xMalloc(sizeof(BPTreeStruct));
+    t->root = NULL;
+    t->esize = esize;
+    t->count = 0;
+    t->height = 0;
+    t->cmp = cmp;
+    t->intKeys = cmp == SORT_INT_ASC && esize == sizeof(int);
+    t->scratch = xMalloc(esize);
+
+    size_t header = sizeof(BPTreeNode);
+    t->leafCapacity = BPTREE_LEAF_BYTES > header ? (BPTREE_LEAF_BYTES - header) / esize : 0;
+    if (t->leafCapacity < BPTREE_MIN_FANOUT) t->leafCapacity = BPTREE_MIN_FANOUT;
+    size_t slot = esize + sizeof(BPTreeNode*);
+    t->innerCapacity = BPTREE_INNER_BYTES > header + 2 * sizeof(BPTreeNode*) + 8
+        ? (BPTREE_INNER_BYTES - header - 2 * sizeof(BPTreeNode*) - 8) / slot : 0;
+    if (t->innerCapacity < BPTREE_MIN_FANOUT) t->innerCapacity = BPTREE_MIN_FANOUT;
+    t->childOffset = ((t->innerCapacity + 1) * esize + 7) & ~(size_t)7;
+    return t;
+}
+
+static BPTreeNode* _insert(BPTree t, BPTreeNode* n, void* data) {
+    size_t i;
+    if (n->leaf) {
+        i = _rank(t, n, data, false);
+        if (i < n->count && t->cmp(_key(t, n, i), data) == 0) {
+            memcpy(_key(t, n, i), data, t->esize);
+            return NULL;
+        }
+        memmove(_key(t, n, i + 1), _key(t, n, i), (n->count - i) * t->esize);
+        memcpy(_key(t, n, i), data, t->esize);
+        n->count++;
+        t->count++;
+        if (n->count <= t->leafCapacity) return NULL;
+
+        BPTreeNode* right = _nodeNew(t, true);
+        size_t mid = n->count / 2;
+        right->count = n->count - (uint32_t)mid;
+        memcpy(_key(t, right, 0), _key(t, n, mid), right->count * t->esize);
+        n->count = (uint32_t)mid;
+        right->next = n->next;
+        right->previous = n;
+        if (n->next) n->next->previous = right;
+        n->next = right;
+        memcpy(t->scratch, _key(t, right, 0), t->esize);
+        return right;
+    }
+
+    i = _rank(t, n, data, true);
+    BPTreeNode* split = _insert(t, _children(t, n)[i], data);
+    if (!split) return NULL;
+
+    BPTreeNode** children = _children(t, n);
+    memmove(_key(t, n, i + 1), _key(t, n, i), (n->count - i) * t->esize);
+    memcpy(_key(t, n, i), t->scratch, t->esize);
+    memmove(&children[i + 2], &children[i + 1], (n->count - i) * sizeof(BPTreeNode*));
+    children[i + 1] = split;
+    n->count++;
+    if (n->count <= t->innerCapacity) return NULL;
+
+    BPTreeNode* right = _nodeNew(t, false);
+    size_t mid = n->count / 2;
+    right->count = n->count - (uint32_t)mid - 1;
+    memcpy(t->scratch, _key(t, n, mid), t->esize);
+    memcpy(_key(t, right, 0), _key(t, n, mid + 1), right->count * t->esize);
+    memcpy(_children(t, right), &children[mid + 1], (right->count + 1) * sizeof(BPTreeNode*));
+    n->count = (uint32_t)mid;
+    return right;
+}
+
+void bpTreeInsert(BPTree t, void* data) {
+    if (!t || !data) return;
+    if (!t->root) {
+        t->root = _nodeNew(t, true);
+        t->height = 1;
+    }
+
+    BPTreeNode* split = _insert(t, t->root, data);
+    if (!split) return;
+
+    BPTreeNode* root = _nodeNew(t, false);
+    memcpy(_key(t, root, 0), t->scratch, t->esize);
+    _children(t, root)[0] = t->root;
+    _children(t, root)[1] = split;
+    root->count = 1;
+    t->root = root;
+    t->height++;
+}
+
+void* bpTreeSearch(BPTree t, void* data) {
+    if (!t || !data) return NULL;
+    BPTreeNode* leaf = _findLeaf(t, data);
+    if (!leaf) return NULL;
+    size_t i = _rank(t, leaf, data, false);
+    if (i < leaf->count && t->cmp(_key(t, leaf, i), data) == 0) return _key(t, leaf, i);
+    return NULL;
+}
+
+bool bpTreeContains(BPTree t, void* data) {
+    return bpTreeSearch(t, data) != NULL;
+}
+
+static void _removeSlot(BPTree t, BPTreeNode* parent, size_t key, size_t child) {
+    BPTreeNode** children = _children(t, parent);
+    memmove(_key(t, parent, key), _key(t, parent, key + 1), (parent->count - key - 1) * t->esize);
+    memmove(&children[child], &children[child + 1], (parent->count - child) * sizeof(BPTreeNode*));
+    parent->count--;
+}
+
+static void _mergeLeaves(BPTree t, BPTreeNode* left, BPTreeNode* right) {
+    memcpy(_key(t, left, left->count), _key(t, right, 0), right->count * t->esize);
+    left->count += right->count;
+    left->next = right->next;
+    if (right->next) right->next->previous = left;
+    xFree(right);
+}
+
+static void _mergeInner(BPTree t, BPTreeNode* left, BPTreeNode* right, const void* separator) {
+    memcpy(_key(t, left, left->count), separator, t->esize);
+    memcpy(_key(t, left, left->count + 1), _key(t, right, 0), right->count * t->esize);
+    memcpy(&_children(t, left)[left->count + 1], _children(t, right), (right->count + 1) * sizeof(BPTreeNode*));
+    left->count += right->count + 1;
+    xFree(right);
+}
+
+static void _fixChild(BPTree t, BPTreeNode* parent, size_t i) {
+    BPTreeNode** children = _children(t, parent);
+    BPTreeNode* child = children[i];
+    BPTreeNode* left = i > 0 ? children[i - 1] : NULL;
+    BPTreeNode* right = i < parent->count ? children[i + 1] : NULL;
+
+    if (child->leaf) {
+        size_t min = t->leafCapacity / 2;
+        if (child->count >= min) return;
+        if (left && left->count > min) {
+            memmove(_key(t, child, 1), _key(t, child, 0), child->count * t->esize);
+            memcpy(_key(t, child, 0), _key(t, left, left->count - 1), t->esize);
+            left->count--;
+            child->count++;
+            memcpy(_key(t, parent, i - 1), _key(t, child, 0), t->esize);
+        } else if (right && right->count > min) {
+            memcpy(_key(t, child, child->count), _key(t, right, 0), t->esize);
+            memmove(_key(t, right, 0), _key(t, right, 1), (right->count - 1) * t->esize);
+            right->count--;
+            child->count++;
+            memcpy(_key(t, parent, i), _key(t, right, 0), t->esize);
+        } else if (left) {
+            _mergeLeaves(t, left, child);
+            _removeSlot(t, parent, i - 1, i);
+        } else if (right) {
+            _mergeLeaves(t, child, right);
+            _removeSlot(t, parent, i, i + 1);
+        }
+        return;
+    }
+
+    size_t min = t->innerCapacity / 2;
+    if (child->count >= min) return;
+    BPTreeNode** childChildren = _children(t, child);
+    if (left && left->count > min) {
+        BPTreeNode** leftChildren = _children(t, left);
+        memmove(_key(t, child, 1), _key(t, child, 0), child->count * t->esize);
+        memmove(&childChildren[1], &childChildren[0], (child->count + 1) * sizeof(BPTreeNode*));
+        memcpy(_key(t, child, 0), _key(t, parent, i - 1), t->esize);
+        childChildren[0] = leftChildren[left->count];
+        memcpy(_key(t, parent, i - 1), _key(t, left, left->count - 1), t->esize);
+        left->count--;
+        child->count++;
+    } else if (right && right->count > min) {
+        BPTreeNode** rightChildren = _children(t, right);
+        memcpy(_key(t, child, child->count), _key(t, parent, i), t->esize);
+        childChildren[child->count + 1] = rightChildren[0];
+        memcpy(_key(t, parent, i), _key(t, right, 0), t->esize);
+        memmove(_key(t, right, 0), _key(t, right, 1), (right->count - 1) * t->esize);
+        memmove(&rightChildren[0], &rightChildren[1], right->count * sizeof(BPTreeNode*));
+        right->count--;
+        child->count++;
+    } else if (left) {
+        _mergeInner(t, left, child, _key(t, parent, i - 1));
+        _removeSlot(t, parent, i - 1, i);
+    } else if (right) {
+        _mergeInner(t, child, right, _key(t, parent, i));
+        _removeSlot(t, parent, i, i + 1);
+    }
+}
+
+static bool _remove(BPTree t, BPTreeNode* n, void* data, void (*freeFn)(void*)) {
+    if (n->leaf) {
+        size_t i = _rank(t, n, data, false);
+        if (i >= n->count || t->cmp(_key(t, n, i), data) != 0) return false;
+        if (freeFn) freeFn(_key(t, n, i));
+        memmove(_key(t, n, i), _key(t, n, i + 1), (n->count - i - 1) * t->esize);
+        n->count--;
+        t->count--;
+        return true;
+    }
+
+    size_t i = _rank(t, n, data, true);
+    if (!_remove(t, _children(t, n)[i], data, freeFn)) return false;
+    _fixChild(t, n, i);
+    return true;
+}
+
+void bpTreeRemove(BPTree t, void* data, void (*freeFn)(void*)) {
+    if (!t || !t->root || !data) return;
+    if (!_remove(t, t->root, data, freeFn)) return;
+
+    if (!t->root->leaf && t->root->count == 0) {
+        BPTreeNode* old = t->root;
+        t->root = _children(t, old)[0];
+        t->height--;
+        xFree(old);
+    } else if (t->root->leaf && t->root->count == 0) {
+        xFree(t->root);
+        t->root = NULL;
+        t->height = 0;
+    }
+}
+
+static void _freeNodes(BPTree t, BPTreeNode* n, void (*freeFn)(void*)) {
+    if (!n->leaf) {
+        for (size_t i = 0; i <= n->count; i++) _freeNodes(t, _children(t, n)[i], freeFn);
+    } else if (freeFn) {
+        for (size_t i = 0; i < n->count; i++) freeFn(_key(t, n, i));
+    }
+    xFree(n);
+}
+
+void bpTreeClear(BPTree t, void (*freeFn)(void*)) {
+    if (!t) return;
+    if (t->root) _freeNodes(t, t->root, freeFn);
+    t->root = NULL;
+    t->count = 0;
+    t->height = 0;
+}
+
+void bpTreeFree(BPTree t, void (*freeFn)(void*)) {
+    if (!t) return;
+    bpTreeClear(t, freeFn);
+    xFree(t->scratch);
+    xFree(t);
+}
+
+size_t bpTreeSize(BPTree t) {
+    return t ? t->count : 0;
+}
+
+static BPTreeNode* _edgeLeaf(BPTree t, bool last) {
+    BPTreeNode* n = t->root;
+    while (n && !n->leaf) n = _children(t, n)[last ? n->count : 0];
+    return n;
+}
+
+void* bpTreeMin(BPTree t) {
+    if (!t || !t->root || t->count == 0) return NULL;
+    return _key(t, _edgeLeaf(t, false), 0);
+}
+
+void* bpTreeMax(BPTree t) {
+    if (!t || !t->root || t->count == 0) return NULL;
+    BPTreeNode* leaf = _edgeLeaf(t, true);
+    return _key(t, leaf, leaf->count - 1);
+}
+
+BPTreeIterator bpTreeSeek(BPTree t, void* lo) {
+    BPTreeIterator it = { t, NULL, 0 };
+    if (!t || !t->root) return it;
+    if (!lo) {
+        it.leaf = _edgeLeaf(t, false);
+        return it;
+    }
+    it.leaf = _findLeaf(t, lo);
+    it.index = _rank(t, it.leaf, lo, false);
+    return it;
+}
+
+void* bpTreeNext(BPTreeIterator* it) {
+    if (!it) return NULL;
+    while (it->leaf && it->index >= it->leaf->count) {
+        it->leaf = it->leaf->next;
+        it->index = 0;
+    }
+    if (!it->leaf) return NULL;
+    return _key(it->tree, it->leaf, it->index++);
+}
+
+size_t bpTreeRange(BPTree t, void* lo, void* hi, bool (*fn)(void* data, void* ctx), void* ctx) {
+    if (!t || !fn) return 0;
+    BPTreeIterator it = bpTreeSeek(t, lo);
+    size_t visited = 0;
+    void* data;
+    while ((data = bpTreeNext(&it))) {
+        if (hi && t->cmp(data, hi) > 0) break;
+        visited++;
+        if (!fn(data, ctx)) break;
+    }
+    return visited;
+}
+
+Array bpTreeToArray(BPTree t) {
+    if (!t) return NULL;
+    Array arr = array(t->esize);
+    for (BPTreeNode* leaf = _edgeLeaf(t, false); leaf; leaf = leaf->next) {
+        while (arr->capacity < arr->len + leaf->count) arrayGrow(arr);
+        memcpy((uint8_t*)arr->data + arr->len * t->esize, leaf->data, leaf->count * t->esize);
+        arr->len += leaf->count;
+    }
+    return arr;
+}
+
+BPTree bpTreeFromSortedArray(Array arr, int (*cmp)(const void*, const void*)) {
+    if (!arr || !cmp) return NULL;
+    BPTree t = bpTreeCreate(arr->esize, cmp);
+
+    uint8_t* src = (uint8_t*)arr->data;
+    size_t n = 0;
+    for (size_t i = 0; i < arr->len; i++)
+        if (i + 1 == arr->len || cmp(src + i * arr->esize, src + (i + 1) * arr->esize) != 0) n++;
+    if (n == 0) return t;
+
+    size_t leaves = (n + t->leafCapacity - 1) / t->leafCapacity;
+    BPTreeNode** level = (BPTreeNode**)xMalloc(leaves * sizeof(BPTreeNode*));
+    BPTreeNode* previous = NULL;
+    for (size_t i = 0, at = 0; i < leaves; i++) {
+        size_t take = n / leaves + (i < n % leaves);
+        BPTreeNode* leaf = _nodeNew(t, true);
+        for (size_t k = 0; k < take; k++, at++) {
+            while (at + 1 < arr->len && cmp(src + at * arr->esize, src + (at + 1) * arr->esize) == 0) at++;
+            memcpy(_key(t, leaf, k), src + at * t->esize, t->esize);
+        }
+        leaf->count = (uint32_t)take;
+        leaf->previous = previous;
+        if (previous) previous->next = leaf;
+        previous = leaf;
+        level[i] = leaf;
+    }
+    t->count = n;
+    t->height = 1;
+
+    size_t width = leaves;
+    while (width > 1) {
+        size_t parents = (width + t->innerCapacity) / (t->innerCapacity + 1);
+        for (size_t i = 0, at = 0; i < parents; i++) {
+            size_t take = width / parents + (i < width % parents);
+            BPTreeNode* node = _nodeNew(t, false);
+            BPTreeNode** children = _children(t, node);
+            for (size_t c = 0; c < take; c++) {
+                children[c] = level[at + c];
+                if (c == 0) continue;
+                BPTreeNode* first = level[at + c];
+                while (!first->leaf) first = _children(t, first)[0];
+                memcpy(_key(t, node, c - 1), _key(t, first, 0), t->esize);
+            }
+            node->count = (uint32_t)(take - 1);
+            level[i] = node;
+            at += take;
+        }
+        width = parents;
+        t->height++;
+    }
+    t->root = level[0];
+    xFree(level);
+    return t;
+}
@@ -0,0 +1,228 @@
+#include <string.h>
+#include <time.h>
+#include "../include/caches.h"
+#include "../include/pointers.h"
+
+#define CACHE_ALIGN _Alignof(max_align_t)
+
+static uint64_t _nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+static inline size_t _valueOffset(size_t keyLen) {
+    return (keyLen + 1 + CACHE_ALIGN - 1) & ~(size_t)(CACHE_ALIGN - 1);
+}
+
+static inline void* _entryValue(CacheEntry* entry) {
+    return entry->data + _valueOffset(entry->keyLen);
+}
+
+static void _unlink(Cache cache, CacheEntry* entry) {
+    if (entry->previous) entry->previous->next = entry->next;
+    else cache->head = entry->next;
+    if (entry->next) entry->next->previous = entry->previous;
+    else cache->tail = entry->previous;
+    entry->previous = NULL;
+    entry->next = NULL;
+}
+
+static void _pushFront(Cache cache, CacheEntry* entry) {
+    entry->previous = NULL;
+    entry->next = cache->head;
+    if (cache->head) cache->head->previous = entry;
+    else cache->tail = entry;
+    cache->head = entry;
+}
+
+static CacheEntry* _lookup(Cache cache, const void* key, size_t len) {
+    CacheEntry** slot = cache->map->strKeys
+        ? (CacheEntry**)mapGetStr(cache->map, (const char*)key, len)
+        : (CacheEntry**)mapGet(cache->map, (void*)key);
+    return slot ? *slot : NULL;
+}
+
+static void _evict(Cache cache, CacheEntry* entry, CacheEvictReason reason) {
+    _unlink(cache, entry);
+    if (cache->map->strKeys) mapRemoveStr(cache->map, entry->data, entry->keyLen, NULL);
+    else mapRemove(cache->map, entry->data, NULL, NULL);
+    cache->count--;
+    cache->bytes -= entry->bytes;
+
+    if (reason == CACHE_EVICT_CAPACITY) cache->evictions++;
+    else if (reason == CACHE_EVICT_EXPIRED) cache->expirations++;
+    if (cache->opts.onEvict) cache->opts.onEvict(entry->data, _entryValue(entry), reason, cache->opts.ctx);
+    xFree(entry);
+}
+
+static bool _expired(CacheEntry* entry, uint64_t now) {
+    return entry->expiresAt && entry->expiresAt <= now;
+}
+
+static void _enforceLimits(Cache cache) {
+    while (cache->tail &&
+           ((cache->opts.maxEntries && cache->count > cache->opts.maxEntries) ||
+            (cache->opts.maxBytes && cache->bytes > cache->opts.maxBytes)))
+        _evict(cache, cache->tail, CACHE_EVICT_CAPACITY);
+}
+
+static void _put(Cache cache, const void* key, size_t len, void* value, size_t bytes, uint64_t ttlMs) {
+    uint64_t expiresAt = ttlMs ? _nowMs() + ttlMs : 0;
+    CacheEntry* entry = _lookup(cache, key, len);
+
+    if (entry) {
+        if (cache->opts.onEvict)
+            cache->opts.onEvict(entry->data, _entryValue(entry), CACHE_EVICT_REPLACED, cache->opts.ctx);
+        if (cache->valueSize > 0) {
+            if (value) memcpy(_entryValue(entry), value, cache->valueSize);
+            else memset(_entryValue(entry), 0, cache->valueSize);
+        }
+        cache->bytes = cache->bytes - entry->bytes + bytes;
+        entry->bytes = bytes;
+        entry->expiresAt = expiresAt;
+        _unlink(cache, entry);
+        _pushFront(cache, entry);
+        _enforceLimits(cache);
+        return;
+    }
+
+    entry = (CacheEntry*)xMalloc(sizeof(CacheEntry) + _valueOffset(len) + cache->valueSize);
+    entry->keyLen = len;
+    entry->bytes = bytes;
+    entry->expiresAt = expiresAt;
+    memcpy(entry->data, key, len);
+    entry->data[len] = '\0';
+    if (cache->valueSize > 0) {
+        if (value) memcpy(_entryValue(entry), value, cache->valueSize);
+        else memset(_entryValue(entry), 0, cache->valueSize);
+    }
+
+    if (cache->map->strKeys) mapPutStr(cache->map, entry->data, len, &entry);
+    else mapPut(cache->map, entry->data, &entry);
+    _pushFront(cache, entry);
+    cache->count++;
+    cache->bytes += bytes;
+    _enforceLimits(cache);
+}
+
+static void* _get(Cache cache, const void* key, size_t len) {
+    CacheEntry* entry = _lookup(cache, key, len);
+    if (entry && _expired(entry, _nowMs())) {
+        _evict(cache, entry, CACHE_EVICT_EXPIRED);
+        entry = NULL;
+    }
+    if (!entry) {
+        cache->misses++;
+        return NULL;
+    }
+
+    cache->hits++;
+    if (cache->head != entry) {
+        _unlink(cache, entry);
+        _pushFront(cache, entry);
+    }
+    return _entryValue(entry);
+}
+
+static Cache _cacheNew(HashMap map, size_t keySize, size_t valueSize, CacheOptions opts) {
+    Cache cache = (Cache)xMalloc(sizeof(CacheStruct));
+    cache->map = map;
+    cache->head = NULL;
+    cache->tail = NULL;
+    cache->keySize = keySize;
+    cache->valueSize = valueSize;
+    cache->count = 0;
+    cache->bytes = 0;
+    cache->opts = opts;
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->evictions = 0;
+    cache->expirations = 0;
+    return cache;
+}
+
+Cache cacheCreate(size_t keySize, size_t valueSize, CacheOptions opts) {
+    HashMap map = mapCreateWithEngine(keySize, sizeof(CacheEntry*), opts.maxEntries, MAP_ENGINE_SWISS);
+    return _cacheNew(map, keySize, valueSize, opts);
+}
+
+Cache cacheCreateStr(size_t valueSize, CacheOptions opts) {
+    HashMap map = mapCreateStrWithEngine(sizeof(CacheEntry*), opts.maxEntries, MAP_ENGINE_SWISS);
+    return _cacheNew(map, 0, valueSize, opts);
+}
+
+void cachePut(Cache cache, void* key, void* value) {
+    if (!cache || !key || cache->map->strKeys) return;
+    _put(cache, key, cache->keySize, value, cache->keySize + cache->valueSize, cache->opts.ttlMs);
+}
+
+void cachePutEx(Cache cache, void* key, void* value, size_t bytes, uint64_t ttlMs) {
+    if (!cache || !key) return;
+    size_t len = cache->map->strKeys ? strlen((const char*)key) : cache->keySize;
+    _put(cache, key, len, value, bytes, ttlMs);
+}
+
+void* cacheGet(Cache cache, void* key) {
+    if (!cache || !key) return NULL;
+    size_t len = cache->map->strKeys ? strlen((const char*)key) : cache->keySize;
+    return _get(cache, key, len);
+}
+
+bool cacheContains(Cache cache, void* key) {
+    if (!cache || !key) return false;
+    size_t len = cache->map->strKeys ? strlen((const char*)key) : cache->keySize;
+    CacheEntry* entry = _lookup(cache, key, len);
+    return entry && !_expired(entry, _nowMs());
+}
+
+void cacheRemove(Cache cache, void* key) {
+    if (!cache || !key) return;
+    size_t len = cache->map->strKeys ? strlen((const char*)key) : cache->keySize;
+    CacheEntry* entry = _lookup(cache, key, len);
+    if (entry) _evict(cache, entry, CACHE_EVICT_REMOVED);
+}
+
+void cachePutStr(Cache cache, const char* key, size_t len, void* value) {
+    if (!cache || !key || !cache->map->strKeys) return;
+    _put(cache, key, len, value, len + cache->valueSize, cache->opts.ttlMs);
+}
+
+void* cacheGetStr(Cache cache, const char* key, size_t len) {
+    if (!cache || !key || !cache->map->strKeys) return NULL;
+    return _get(cache, key, len);
+}
+
+void cacheRemoveStr(Cache cache, const char* key, size_t len) {
+    if (!cache || !key || !cache->map->strKeys) return;
+    CacheEntry* entry = _lookup(cache, key, len);
+    if (entry) _evict(cache, entry, CACHE_EVICT_REMOVED);
+}
+
+size_t cachePurgeExpired(Cache cache) {
+    if (!cache) return 0;
+    uint64_t now = _nowMs();
+    size_t purged = 0;
+    CacheEntry* current = cache->head;
+    while (current) {
+        CacheEntry* next = current->next;
+        if (_expired(current, now)) {
+            _evict(cache, current, CACHE_EVICT_EXPIRED);
+            purged++;
+        }
+        current = next;
+    }
+    return purged;
+}
+
+void cacheClear(Cache cache) {
+    if (!cache) return;
+    while (cache->head) _evict(cache, cache->head, CACHE_EVICT_REMOVED);
+}
+
+void cacheFree(Cache cache) {
+    if (!cache) return;
+    cacheClear(cache);
+    mapFree(cache->map, NULL, NULL);
+    xFree(cache);
+}
@@ -0,0 +1,132 @@
+#include <pthread.h>
+#include "../include/epochs.h"
+#include "../include/pointers.h"
+
+#define EPOCH_ACTIVE ((uint_fast64_t)1)
+
+typedef struct EpochRecord {
+    atomic_uint_fast64_t epoch;
+    atomic_bool used;
+    unsigned depth;
+    struct EpochRecord* next;
+    char pad[128];
+} EpochRecord;
+
+static atomic_uint_fast64_t _globalEpoch = 1;
+static _Atomic(EpochRecord*) _records = NULL;
+static _Thread_local EpochRecord* _self = NULL;
+static pthread_key_t _recordKey;
+static pthread_once_t _recordOnce = PTHREAD_ONCE_INIT;
+
+static void _recordRelease(void* p) {
+    EpochRecord* r = (EpochRecord*)p;
+    r->depth = 0;
+    atomic_store_explicit(&r->epoch, 0, memory_order_release);
+    atomic_store_explicit(&r->used, false, memory_order_release);
+}
+
+static void _recordKeyCreate(void) {
+    pthread_key_create(&_recordKey, _recordRelease);
+}
+
+static EpochRecord* _recordAcquire(void) {
+    pthread_once(&_recordOnce, _recordKeyCreate);
+
+    EpochRecord* r = atomic_load(&_records);
+    for (; r; r = r->next) {
+        bool expected = false;
+        if (!atomic_load_explicit(&r->used, memory_order_relaxed) && atomic_compare_exchange_strong(&r->used, &expected, true))
+            break;
+    }
+    if (!r) {
+        r = (EpochRecord*)xMalloc(sizeof(EpochRecord));
+        atomic_init(&r->epoch, 0);
+        atomic_init(&r->used, true);
+        r->depth = 0;
+        r->next = atomic_load(&_records);
+        while (!atomic_compare_exchange_weak(&_records, &r->next, r));
+    }
+    pthread_setspecific(_recordKey, r);
+    _self = r;
+    return r;
+}
+
+static uint64_t _tryAdvance(void) {
+    uint_fast64_t global = atomic_load(&_globalEpoch);
+    atomic_thread_fence(memory_order_seq_cst);
+    for (EpochRecord* r = atomic_load(&_records); r; r = r->next) {
+        uint_fast64_t e = atomic_load_explicit(&r->epoch, memory_order_acquire);
+        if ((e & EPOCH_ACTIVE) && (e >> 1) != global) return global;
+    }
+    if (atomic_compare_exchange_strong(&_globalEpoch, &global, global + 1)) return global + 1;
+    return global;
+}
+
+void epochEnter(void) {
+    EpochRecord* r = _self ? _self : _recordAcquire();
+    if (r->depth++ > 0) return;
+    uint_fast64_t global = atomic_load_explicit(&_globalEpoch, memory_order_relaxed);
+    atomic_store_explicit(&r->epoch, (global << 1) | EPOCH_ACTIVE, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+void epochExit(void) {
+    EpochRecord* r = _self;
+    if (!r || r->depth == 0 || --r->depth > 0) return;
+    atomic_store_explicit(&r->epoch, 0, memory_order_release);
+}
+
+void epochListInit(EpochList* list) {
+    atomic_init(&list->head, NULL);
+}
+
+static void _listPush(EpochList* list, EpochRetired* first, EpochRetired* last) {
+    EpochRetired* head = atomic_load_explicit(&list->head, memory_order_relaxed);
+    do last->next = head;
+    while (!atomic_compare_exchange_weak_explicit(&list->head, &head, first, memory_order_release, memory_order_relaxed));
+}
+
+void epochRetire(EpochList* list, void* ptr, void (*freeFn)(void*)) {
+    if (!list || !ptr) return;
+    EpochRetired* r = (EpochRetired*)xMalloc(sizeof(EpochRetired));
+    r->ptr = ptr;
+    r->freeFn = freeFn;
+    r->epoch = atomic_load(&_globalEpoch);
+    _listPush(list, r, r);
+}
+
+size_t epochReclaim(EpochList* list) {
+    if (!list || !atomic_load_explicit(&list->head, memory_order_relaxed)) return 0;
+    uint64_t global = _tryAdvance();
+
+    EpochRetired* r = atomic_exchange_explicit(&list->head, NULL, memory_order_acquire);
+    EpochRetired* keep = NULL;
+    EpochRetired* keepTail = NULL;
+    size_t freed = 0;
+    while (r) {
+        EpochRetired* next = r->next;
+        if (r->epoch + 2 <= global) {
+            if (r->freeFn) r->freeFn(r->ptr);
+            xFree(r);
+            freed++;
+        } else {
+            r->next = keep;
+            keep = r;
+            if (!keepTail) keepTail = r;
+        }
+        r = next;
+    }
+    if (keep) _listPush(list, keep, keepTail);
+    return freed;
+}
+
+void epochDrain(EpochList* list) {
+    if (!list) return;
+    EpochRetired* r = atomic_exchange(&list->head, NULL);
+    while (r) {
+        EpochRetired* next = r->next;
+        if (r->freeFn) r->freeFn(r->ptr);
+        xFree(r);
+        r = next;
+    }
+}
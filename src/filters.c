@@ -0,0 +1,379 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include "../include/filters.h"
+#include "../include/maps.h"
+#include "../include/pointers.h"
+
+#define BLOOM_WORDS      8
+#define BLOOM_BLOCK      (BLOOM_WORDS * sizeof(uint32_t))
+#define BLOOM_ALIGN      64
+#define CUCKOO_SLOTS     4
+#define CUCKOO_LOAD      0.95
+#define CUCKOO_MAX_KICKS 500
+
+static const char _bloomMagic[8] = { 'C', 'D', 'S', 'B', 'L', 'O', 'O', 'M' };
+static const char _cuckooMagic[8] = { 'C', 'D', 'S', 'C', 'U', 'C', 'K', 'O' };
+
+static const uint32_t _bloomSalt[BLOOM_WORDS] = {
+    0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+    0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+};
+
+static bool _writeHeader(FILE* fp, const char magic[8], const uint64_t* fields, size_t n) {
+    if (fwrite(magic, 1, 8, fp) != 8) return false;
+    return fwrite(fields, sizeof(uint64_t), n, fp) == n;
+}
+
+static bool _readHeader(FILE* fp, const char magic[8], uint64_t* fields, size_t n) {
+    char buf[8];
+    if (fread(buf, 1, 8, fp) != 8 || memcmp(buf, magic, 8) != 0) return false;
+    return fread(fields, sizeof(uint64_t), n, fp) == n;
+}
+
+static bool _payloadMatches(FILE* fp, uint64_t count, uint64_t unit) {
+    if (count == 0 || count > (SIZE_MAX - BLOOM_ALIGN) / unit) return false;
+    long start = ftell(fp);
+    if (start < 0 || fseek(fp, 0, SEEK_END) != 0) return false;
+    long end = ftell(fp);
+    if (end < start || (uint64_t)(end - start) != count * unit) return false;
+    return fseek(fp, start, SEEK_SET) == 0;
+}
+
+static void _bloomAlloc(BloomFilter filter, size_t blockCount) {
+    filter->blockCount = blockCount;
+    filter->memory = xCalloc(blockCount * BLOOM_BLOCK + BLOOM_ALIGN, 1);
+    uintptr_t p = ((uintptr_t)filter->memory + BLOOM_ALIGN - 1) & ~(uintptr_t)(BLOOM_ALIGN - 1);
+    filter->blocks = (uint32_t*)p;
+}
+
+static inline uint32_t* _bloomBlock(BloomFilter filter, uint64_t hash) {
+    size_t index = (size_t)(((hash >> 32) * (uint64_t)filter->blockCount) >> 32);
+    return filter->blocks + index * BLOOM_WORDS;
+}
+
+static double _bloomRate(double keysPerBlock) {
+    double rate = 0.0;
+    double poisson = exp(-keysPerBlock);
+    double limit = keysPerBlock + 10.0 * sqrt(keysPerBlock) + 20.0;
+    for (double x = 0.0; x < limit; x += 1.0) {
+        rate += poisson * pow(1.0 - pow(1.0 - 1.0 / 32.0, x), BLOOM_WORDS);
+        poisson *= keysPerBlock / (x + 1.0);
+    }
+    return rate;
+}
+
+BloomFilter bloomFilterCreate(size_t keySize, size_t expected, double fpr) {
+    if (fpr <= 0.0 || fpr >= 1.0) fpr = 0.01;
+    if (expected == 0) expected = 1;
+
+    double lo = 1.0, hi = 64.0;
+    for (int i = 0; i < 40; i++) {
+        double mid = (lo + hi) / 2;
+        if (_bloomRate((BLOOM_BLOCK * 8) / mid) > fpr) lo = mid;
+        else hi = mid;
+    }
+    size_t blockCount = (size_t)ceil((double)expected * hi / (BLOOM_BLOCK * 8));
+    if (blockCount == 0) blockCount = 1;
+
+    BloomFilter filter = (BloomFilter)xMalloc(sizeof(BloomFilterStruct));
+    filter->keySize = keySize;
+    filter->count = 0;
+    filter->seed = hashSeed();
+    _bloomAlloc(filter, blockCount);
+    return filter;
+}
+
+BloomFilter bloomFilterFromArray(Array arr, double fpr) {
+    if (!arr) return NULL;
+    BloomFilter filter = bloomFilterCreate(arr->esize, arr->len, fpr);
+    for (size_t i = 0; i < arr->len; i++)
+        bloomFilterAdd(filter, (uint8_t*)arr->data + i * arr->esize);
+    return filter;
+}
+
+void bloomFilterAdd(BloomFilter filter, void* key) {
+    if (!filter || !key) return;
+    uint64_t hash = hashBytes(key, filter->keySize, filter->seed);
+    uint32_t* block = _bloomBlock(filter, hash);
+    uint32_t h = (uint32_t)hash;
+#ifdef __AVX2__
+    __m256i salt = _mm256_loadu_si256((const __m256i*)_bloomSalt);
+    __m256i shift = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int)h), salt), 27);
+    __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), shift);
+    __m256i current = _mm256_load_si256((const __m256i*)block);
+    _mm256_store_si256((__m256i*)block, _mm256_or_si256(current, mask));
+#else
+    for (int i = 0; i < BLOOM_WORDS; i++)
+        block[i] |= 1u << ((h * _bloomSalt[i]) >> 27);
+#endif
+    filter->count++;
+}
+
+bool bloomFilterContains(BloomFilter filter, void* key) {
+    if (!filter || !key) return false;
+    uint64_t hash = hashBytes(key, filter->keySize, filter->seed);
+    const uint32_t* block = _bloomBlock(filter, hash);
+    uint32_t h = (uint32_t)hash;
+#ifdef __AVX2__
+    __m256i salt = _mm256_loadu_si256((const __m256i*)_bloomSalt);
+    __m256i shift = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int)h), salt), 27);
+    __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), shift);
+    return _mm256_testc_si256(_mm256_load_si256((const __m256i*)block), mask);
+#else
+    uint32_t miss = 0;
+    for (int i = 0; i < BLOOM_WORDS; i++)
+        miss |= ~block[i] & (1u << ((h * _bloomSalt[i]) >> 27));
+    return miss == 0;
+#endif
+}
+
+bool bloomFilterSave(BloomFilter filter, const char* path) {
+    if (!filter || !path) return false;
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return false;
+
+    uint64_t fields[4] = { filter->blockCount, filter->keySize, filter->count, filter->seed };
+    bool ok = _writeHeader(fp, _bloomMagic, fields, 4) &&
+              fwrite(filter->blocks, BLOOM_BLOCK, filter->blockCount, fp) == filter->blockCount;
+    fclose(fp);
+    return ok;
+}
+
+BloomFilter bloomFilterLoad(const char* path) {
+    if (!path) return NULL;
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return NULL;
+
+    uint64_t fields[4];
+    if (!_readHeader(fp, _bloomMagic, fields, 4) || !_payloadMatches(fp, fields[0], BLOOM_BLOCK)) {
+        fclose(fp);
+        return NULL;
+    }
+
+    BloomFilter filter = (BloomFilter)xMalloc(sizeof(BloomFilterStruct));
+    filter->keySize = (size_t)fields[1];
+    filter->count = (size_t)fields[2];
+    filter->seed = fields[3];
+    _bloomAlloc(filter, (size_t)fields[0]);
+    if (fread(filter->blocks, BLOOM_BLOCK, filter->blockCount, fp) != filter->blockCount) {
+        bloomFilterFree(filter);
+        filter = NULL;
+    }
+    fclose(fp);
+    return filter;
+}
+
+void bloomFilterFree(BloomFilter filter) {
+    if (!filter) return;
+    xFree(filter->memory);
+    xFree(filter);
+}
+
+static inline uint16_t _cuckooGet(CuckooFilter filter, size_t bucket, size_t slot) {
+    size_t i = bucket * CUCKOO_SLOTS + slot;
+    if (filter->fingerprintBytes == 1) return filter->table[i];
+    uint16_t fp;
+    memcpy(&fp, filter->table + i * 2, 2);
+    return fp;
+}
+
+static inline void _cuckooSet(CuckooFilter filter, size_t bucket, size_t slot, uint16_t fp) {
+    size_t i = bucket * CUCKOO_SLOTS + slot;
+    if (filter->fingerprintBytes == 1) filter->table[i] = (uint8_t)fp;
+    else memcpy(filter->table + i * 2, &fp, 2);
+}
+
+static inline size_t _cuckooAlt(CuckooFilter filter, size_t index, uint16_t fp) {
+    uint64_t h = (uint64_t)fp * 0x5bd1e9955bd1e995ull;
+    return (index ^ (size_t)(h >> 32)) & (filter->bucketCount - 1);
+}
+
+static inline void _cuckooLocate(CuckooFilter filter, void* key, size_t* index, uint16_t* fp) {
+    uint64_t hash = hashBytes(key, filter->keySize, filter->seed);
+    uint16_t mask = filter->fingerprintBytes == 1 ? 0xFF : 0xFFFF;
+    uint16_t f = (uint16_t)(hash >> 48) & mask;
+    *fp = f ? f : 1;
+    *index = (size_t)hash & (filter->bucketCount - 1);
+}
+
+static bool _cuckooPlace(CuckooFilter filter, size_t bucket, uint16_t fp) {
+    for (size_t slot = 0; slot < CUCKOO_SLOTS; slot++) {
+        if (_cuckooGet(filter, bucket, slot) == 0) {
+            _cuckooSet(filter, bucket, slot, fp);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool _cuckooHas(CuckooFilter filter, size_t bucket, uint16_t fp) {
+    for (size_t slot = 0; slot < CUCKOO_SLOTS; slot++)
+        if (_cuckooGet(filter, bucket, slot) == fp) return true;
+    return false;
+}
+
+static bool _cuckooErase(CuckooFilter filter, size_t bucket, uint16_t fp) {
+    for (size_t slot = 0; slot < CUCKOO_SLOTS; slot++) {
+        if (_cuckooGet(filter, bucket, slot) == fp) {
+            _cuckooSet(filter, bucket, slot, 0);
+            return true;
+        }
+    }
+    return false;
+}
+
+static CuckooFilter _cuckooNew(size_t keySize, size_t bucketCount, size_t fingerprintBytes, uint64_t seed) {
+    CuckooFilter filter = (CuckooFilter)xMalloc(sizeof(CuckooFilterStruct));
+    filter->keySize = keySize;
+    filter->bucketCount = bucketCount;
+    filter->fingerprintBytes = fingerprintBytes;
+    filter->seed = seed;
+    filter->count = 0;
+    filter->hasVictim = false;
+    filter->victimIndex = 0;
+    filter->victimFingerprint = 0;
+    filter->table = (uint8_t*)xCalloc(bucketCount * CUCKOO_SLOTS, fingerprintBytes);
+    return filter;
+}
+
+CuckooFilter cuckooFilterCreate(size_t keySize, size_t expected, double fpr) {
+    if (fpr <= 0.0 || fpr >= 1.0) fpr = 0.01;
+    if (expected == 0) expected = 1;
+
+    size_t fingerprintBytes = log2(2.0 * CUCKOO_SLOTS / fpr) > 8.0 ? 2 : 1;
+    size_t bucketCount = 1;
+    while ((double)bucketCount * CUCKOO_SLOTS * CUCKOO_LOAD < (double)expected) bucketCount *= 2;
+    return _cuckooNew(keySize, bucketCount, fingerprintBytes, hashSeed());
+}
+
+CuckooFilter cuckooFilterFromArray(Array arr, double fpr) {
+    if (!arr) return NULL;
+    CuckooFilter filter = cuckooFilterCreate(arr->esize, arr->len, fpr);
+    for (size_t i = 0; i < arr->len; i++)
+        cuckooFilterAdd(filter, (uint8_t*)arr->data + i * arr->esize);
+    return filter;
+}
+
+bool cuckooFilterAdd(CuckooFilter filter, void* key) {
+    if (!filter || !key || filter->hasVictim) return false;
+
+    size_t index;
+    uint16_t fp;
+    _cuckooLocate(filter, key, &index, &fp);
+    if (_cuckooPlace(filter, index, fp) || _cuckooPlace(filter, _cuckooAlt(filter, index, fp), fp)) {
+        filter->count++;
+        return true;
+    }
+
+    size_t kick = (size_t)fp;
+    if (kick & 1) index = _cuckooAlt(filter, index, fp);
+    for (int n = 0; n < CUCKOO_MAX_KICKS; n++) {
+        size_t slot = (kick + (size_t)n) % CUCKOO_SLOTS;
+        uint16_t evicted = _cuckooGet(filter, index, slot);
+        _cuckooSet(filter, index, slot, fp);
+        fp = evicted;
+        index = _cuckooAlt(filter, index, fp);
+        if (_cuckooPlace(filter, index, fp)) {
+            filter->count++;
+            return true;
+        }
+    }
+
+    filter->hasVictim = true;
+    filter->victimIndex = index;
+    filter->victimFingerprint = fp;
+    filter->count++;
+    return true;
+}
+
+bool cuckooFilterContains(CuckooFilter filter, void* key) {
+    if (!filter || !key) return false;
+
+    size_t index;
+    uint16_t fp;
+    _cuckooLocate(filter, key, &index, &fp);
+    size_t alt = _cuckooAlt(filter, index, fp);
+    if (_cuckooHas(filter, index, fp) || _cuckooHas(filter, alt, fp)) return true;
+    return filter->hasVictim && filter->victimFingerprint == fp &&
+           (filter->victimIndex == index || filter->victimIndex == alt);
+}
+
+bool cuckooFilterRemove(CuckooFilter filter, void* key) {
+    if (!filter || !key) return false;
+
+    size_t index;
+    uint16_t fp;
+    _cuckooLocate(filter, key, &index, &fp);
+    size_t alt = _cuckooAlt(filter, index, fp);
+
+    if (filter->hasVictim && filter->victimFingerprint == fp &&
+        (filter->victimIndex == index || filter->victimIndex == alt)) {
+        filter->hasVictim = false;
+    } else if (!_cuckooErase(filter, index, fp) && !_cuckooErase(filter, alt, fp)) {
+        return false;
+    }
+    filter->count--;
+
+    if (filter->hasVictim) {
+        size_t victimAlt = _cuckooAlt(filter, filter->victimIndex, filter->victimFingerprint);
+        if (_cuckooPlace(filter, filter->victimIndex, filter->victimFingerprint) ||
+            _cuckooPlace(filter, victimAlt, filter->victimFingerprint))
+            filter->hasVictim = false;
+    }
+    return true;
+}
+
+bool cuckooFilterSave(CuckooFilter filter, const char* path) {
+    if (!filter || !path) return false;
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return false;
+
+    uint64_t fields[7] = {
+        filter->bucketCount, filter->fingerprintBytes, filter->keySize, filter->count,
+        filter->seed, filter->hasVictim ? filter->victimIndex : UINT64_MAX, filter->victimFingerprint
+    };
+    size_t bytes = filter->bucketCount * CUCKOO_SLOTS * filter->fingerprintBytes;
+    bool ok = _writeHeader(fp, _cuckooMagic, fields, 7) && fwrite(filter->table, 1, bytes, fp) == bytes;
+    fclose(fp);
+    return ok;
+}
+
+CuckooFilter cuckooFilterLoad(const char* path) {
+    if (!path) return NULL;
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return NULL;
+
+    uint64_t fields[7];
+    if (!_readHeader(fp, _cuckooMagic, fields, 7) || fields[0] == 0 || (fields[0] & (fields[0] - 1)) ||
+        (fields[1] != 1 && fields[1] != 2) || fields[0] > SIZE_MAX / CUCKOO_SLOTS ||
+        !_payloadMatches(fp, fields[0] * CUCKOO_SLOTS, fields[1]) ||
+        fields[3] > fields[0] * CUCKOO_SLOTS + 1 ||
+        (fields[5] != UINT64_MAX && (fields[5] >= fields[0] || fields[6] == 0 || fields[6] >> (8 * fields[1])))) {
+        fclose(fp);
+        return NULL;
+    }
+
+    CuckooFilter filter = _cuckooNew((size_t)fields[2], (size_t)fields[0], (size_t)fields[1], fields[4]);
+    filter->count = (size_t)fields[3];
+    filter->hasVictim = fields[5] != UINT64_MAX;
+    filter->victimIndex = filter->hasVictim ? (size_t)fields[5] : 0;
+    filter->victimFingerprint = (uint16_t)fields[6];
+
+    size_t bytes = filter->bucketCount * CUCKOO_SLOTS * filter->fingerprintBytes;
+    if (fread(filter->table, 1, bytes, fp) != bytes) {
+        cuckooFilterFree(filter);
+        filter = NULL;
+    }
+    fclose(fp);
+    return filter;
+}
+
+void cuckooFilterFree(CuckooFilter filter) {
+    if (!filter) return;
+    xFree(filter->table);
+    xFree(filter);
+}
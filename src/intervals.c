@@ -0,0 +1,211 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/intervals.h"
+#include "../include/pointers.h"
+
+static IntervalNode* _nodeNew(IntervalTree t, int64_t start, int64_t end, void* value) {
+    IntervalNode* n = (IntervalNode*)xMalloc(sizeof(IntervalNode) + t->valueSize);
+    n->start = start;
+    n->end = end;
+    n->maxEnd = end;
+    n->left = NULL;
+    n->right = NULL;
+    n->height = 1;
+    if (t->valueSize) memcpy(n->value, value, t->valueSize);
+    return n;
+}
+
+static inline int _height(IntervalNode* n) {
+    return n ? n->height : 0;
+}
+
+static inline void _updateNode(IntervalNode* n) {
+    int l = _height(n->left);
+    int r = _height(n->right);
+    n->height = (l > r ? l : r) + 1;
+    n->maxEnd = n->end;
+    if (n->left && n->left->maxEnd > n->maxEnd) n->maxEnd = n->left->maxEnd;
+    if (n->right && n->right->maxEnd > n->maxEnd) n->maxEnd = n->right->maxEnd;
+}
+
+static IntervalNode* _rotateLeft(IntervalNode* n) {
+    IntervalNode* r = n->right;
+    n->right = r->left;
+    r->left = n;
+    _updateNode(n);
+    _updateNode(r);
+    return r;
+}
+
+static IntervalNode* _rotateRight(IntervalNode* n) {
+    IntervalNode* l = n->left;
+    n->left = l->right;
+    l->right = n;
+    _updateNode(n);
+    _updateNode(l);
+    return l;
+}
+
+static IntervalNode* _rebalance(IntervalNode* n) {
+    _updateNode(n);
+    int balance = _height(n->left) - _height(n->right);
+    if (balance > 1) {
+        if (_height(n->left->left) < _height(n->left->right))
+            n->left = _rotateLeft(n->left);
+        return _rotateRight(n);
+    }
+    if (balance < -1) {
+        if (_height(n->right->right) < _height(n->right->left))
+            n->right = _rotateRight(n->right);
+        return _rotateLeft(n);
+    }
+    return n;
+}
+
+static inline int _compare(int64_t start, int64_t end, IntervalNode* n) {
+    if (start != n->start) return start < n->start ? -1 : 1;
+    if (end != n->end) return end < n->end ? -1 : 1;
+    return 0;
+}
+
+IntervalTree intervalTreeCreate(size_t valueSize) {
+    IntervalTree t = (IntervalTree)xMalloc(sizeof(IntervalTreeStruct));
+    t->root = NULL;
+    t->valueSize = valueSize;
+    t->count = 0;
+    return t;
+}
+
+static IntervalNode* _insertNode(IntervalTree t, IntervalNode* root, IntervalNode* n) {
+    if (!root) return n;
+    if (_compare(n->start, n->end, root) < 0) root->left = _insertNode(t, root->left, n);
+    else root->right = _insertNode(t, root->right, n);
+    return _rebalance(root);
+}
+
+void intervalTreeInsert(IntervalTree t, int64_t start, int64_t end, void* value) {
+    if (!t || start >= end) return;
+    t->root = _insertNode(t, t->root, _nodeNew(t, start, end, value));
+    t->count++;
+}
+
+static IntervalNode* _detachMin(IntervalNode* root, IntervalNode** min) {
+    if (!root->left) {
+        *min = root;
+        return root->right;
+    }
+    root->left = _detachMin(root->left, min);
+    return _rebalance(root);
+}
+
+static IntervalNode* _removeNode(IntervalTree t, IntervalNode* root, int64_t start, int64_t end, void* value, IntervalNode** removed) {
+    if (!root) return NULL;
+
+    int r = _compare(start, end, root);
+    if (r < 0) {
+        root->left = _removeNode(t, root->left, start, end, value, removed);
+    } else if (r > 0) {
+        root->right = _removeNode(t, root->right, start, end, value, removed);
+    } else if (value && t->valueSize && memcmp(root->value, value, t->valueSize) != 0) {
+        root->left = _removeNode(t, root->left, start, end, value, removed);
+        if (!*removed) root->right = _removeNode(t, root->right, start, end, value, removed);
+    } else {
+        *removed = root;
+        if (!root->left) return root->right;
+        if (!root->right) return root->left;
+        IntervalNode* successor;
+        IntervalNode* right = _detachMin(root->right, &successor);
+        successor->left = root->left;
+        successor->right = right;
+        return _rebalance(successor);
+    }
+    return *removed ? _rebalance(root) : root;
+}
+
+bool intervalTreeRemove(IntervalTree t, int64_t start, int64_t end, void* value, void (*valFree)(void*)) {
+    if (!t || !t->root) return false;
+    IntervalNode* removed = NULL;
+    t->root = _removeNode(t, t->root, start, end, value, &removed);
+    if (!removed) return false;
+    if (valFree) valFree(removed->value);
+    xFree(removed);
+    t->count--;
+    return true;
+}
+
+static bool _query(IntervalNode* n, int64_t lo, int64_t hi, bool (*fn)(const Interval*, void*), void* ctx, size_t* visited) {
+    while (n) {
+        if (n->maxEnd <= lo) return true;
+        if (!_query(n->left, lo, hi, fn, ctx, visited)) return false;
+        if (n->start > hi) return true;
+        if (n->end > lo) {
+            Interval iv = { n->start, n->end, n->value };
+            (*visited)++;
+            if (!fn(&iv, ctx)) return false;
+        }
+        n = n->right;
+    }
+    return true;
+}
+
+size_t intervalTreeStab(IntervalTree t, int64_t point, bool (*fn)(const Interval* iv, void* ctx), void* ctx) {
+    if (!t || !fn) return 0;
+    size_t visited = 0;
+    _query(t->root, point, point, fn, ctx, &visited);
+    return visited;
+}
+
+size_t intervalTreeOverlap(IntervalTree t, int64_t start, int64_t end, bool (*fn)(const Interval* iv, void* ctx), void* ctx) {
+    if (!t || !fn || start >= end) return 0;
+    size_t visited = 0;
+    _query(t->root, start, end - 1, fn, ctx, &visited);
+    return visited;
+}
+
+static bool _collect(const Interval* iv, void* ctx) {
+    arrayAdd((Array)ctx, (void*)iv);
+    return true;
+}
+
+size_t intervalTreeStabInto(IntervalTree t, int64_t point, Array out) {
+    if (!out || out->esize != sizeof(Interval)) return 0;
+    return intervalTreeStab(t, point, _collect, out);
+}
+
+size_t intervalTreeOverlapInto(IntervalTree t, int64_t start, int64_t end, Array out) {
+    if (!out || out->esize != sizeof(Interval)) return 0;
+    return intervalTreeOverlap(t, start, end, _collect, out);
+}
+
+size_t intervalTreeSize(IntervalTree t) {
+    return t ? t->count : 0;
+}
+
+static void _nodeFreeAll(IntervalNode* n, void (*valFree)(void*)) {
+    while (n) {
+        if (n->left) {
+            IntervalNode* left = n->left;
+            n->left = left->right;
+            left->right = n;
+            n = left;
+            continue;
+        }
+        IntervalNode* next = n->right;
+        if (valFree) valFree(n->value);
+        xFree(n);
+        n = next;
+    }
+}
+
+void intervalTreeClear(IntervalTree t, void (*valFree)(void*)) {
+    if (!t) return;
+    _nodeFreeAll(t->root, valFree);
+    t->root = NULL;
+    t->count = 0;
+}
+
+void intervalTreeFree(IntervalTree t, void (*valFree)(void*)) {
+    if (!t) return;
+    intervalTreeClear(t, valFree);
+    xFree(t);
+}
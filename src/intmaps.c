@@ -0,0 +1,219 @@
+#include <string.h>
+#include "../include/intmaps.h"
+#include "../include/maps.h"
+#include "../include/pointers.h"
+
+#define INTMAP_MIN_CAPACITY 16
+#define INTMAP_LOAD_NUM     3
+#define INTMAP_LOAD_DEN     4
+
+#define INTMAP_DEFINE(Name, prefix, KeyType)                                           \
+    static inline size_t _##prefix##Slot(Name map, KeyType key) {                      \
+        uint64_t x = (uint64_t)key ^ map->seed;                                        \
+        x ^= x >> 32;                                                                  \
+        return (size_t)((x * 0x9e3779b97f4a7c15ull) >> map->shift);                    \
+    }                                                                                  \
+                                                                                       \
+    static inline bool _##prefix##Empty(Name map, size_t i) {                          \
+        return map->sentinel ? map->keys[i] == map->emptyKey : !map->used[i];          \
+    }                                                                                  \
+                                                                                       \
+    static inline void* _##prefix##Value(Name map, size_t i) {                         \
+        return map->valueSize > 0 ? map->values + i * map->valueSize : NULL;           \
+    }                                                                                  \
+                                                                                       \
+    static void _##prefix##Alloc(Name map, size_t capacity) {                          \
+        unsigned bits = 0;                                                             \
+        while (((size_t)1 << bits) < capacity) bits++;                                 \
+        map->capacity = capacity;                                                      \
+        map->shift = 64 - bits;                                                        \
+        map->keys = (KeyType*)xMalloc(capacity * sizeof(KeyType));                     \
+        if (map->sentinel) {                                                           \
+            map->used = NULL;                                                          \
+            for (size_t i = 0; i < capacity; i++) map->keys[i] = map->emptyKey;        \
+        } else {                                                                       \
+            map->used = (uint8_t*)xCalloc(capacity, 1);                                \
+        }                                                                              \
+        map->values = map->valueSize > 0                                               \
+            ? (uint8_t*)xMalloc((capacity + 1) * map->valueSize) : NULL;               \
+    }                                                                                  \
+                                                                                       \
+    static size_t _##prefix##Find(Name map, KeyType key) {                             \
+        size_t mask = map->capacity - 1;                                               \
+        size_t i = _##prefix##Slot(map, key);                                          \
+        while (!_##prefix##Empty(map, i)) {                                            \
+            if (map->keys[i] == key) return i;                                         \
+            i = (i + 1) & mask;                                                        \
+        }                                                                              \
+        return (size_t)-1;                                                             \
+    }                                                                                  \
+                                                                                       \
+    static void _##prefix##Insert(Name map, KeyType key, const void* value) {          \
+        size_t mask = map->capacity - 1;                                               \
+        size_t i = _##prefix##Slot(map, key);                                          \
+        while (!_##prefix##Empty(map, i)) {                                            \
+            if (map->keys[i] == key) break;                                            \
+            i = (i + 1) & mask;                                                        \
+        }                                                                              \
+        if (_##prefix##Empty(map, i)) {                                                \
+            map->keys[i] = key;                                                        \
+            if (!map->sentinel) map->used[i] = 1;                                      \
+            map->count++;                                                              \
+            if (map->valueSize > 0 && !value)                                          \
+                memset(_##prefix##Value(map, i), 0, map->valueSize);                   \
+        }                                                                              \
+        if (map->valueSize > 0 && value)                                               \
+            memcpy(_##prefix##Value(map, i), value, map->valueSize);                   \
+    }                                                                                  \
+                                                                                       \
+    static void _##prefix##Resize(Name map, size_t capacity) {                         \
+        KeyType* keys = map->keys;                                                     \
+        uint8_t* used = map->used;                                                     \
+        uint8_t* values = map->values;                                                 \
+        size_t oldCapacity = map->capacity;                                            \
+                                                                                       \
+        _##prefix##Alloc(map, capacity);                                               \
+        map->count = map->hasEmptyKey ? 1 : 0;                                         \
+        if (values)                                                                    \
+            memcpy(_##prefix##Value(map, capacity),                                    \
+                   values + oldCapacity * map->valueSize, map->valueSize);             \
+        for (size_t i = 0; i < oldCapacity; i++) {                                     \
+            if (map->sentinel ? keys[i] == map->emptyKey : !used[i]) continue;         \
+            _##prefix##Insert(map, keys[i], values ? values + i * map->valueSize : NULL); \
+        }                                                                              \
+        xFree(keys);                                                                   \
+        xFree(used);                                                                   \
+        xFree(values);                                                                 \
+    }                                                                                  \
+                                                                                       \
+    static Name _##prefix##New(size_t valueSize, size_t capacity, bool sentinel, KeyType emptyKey) { \
+        Name map = (Name)xMalloc(sizeof(Name##Struct));                                \
+        map->count = 0;                                                                \
+        map->valueSize = valueSize;                                                    \
+        map->seed = hashSeed();                                                        \
+        map->sentinel = sentinel;                                                      \
+        map->hasEmptyKey = false;                                                      \
+        map->emptyKey = emptyKey;                                                      \
+        size_t needed = INTMAP_MIN_CAPACITY;                                           \
+        while (needed * INTMAP_LOAD_NUM < capacity * INTMAP_LOAD_DEN) needed *= 2;     \
+        _##prefix##Alloc(map, needed);                                                 \
+        return map;                                                                    \
+    }                                                                                  \
+                                                                                       \
+    Name prefix##Create(size_t valueSize, size_t capacity) {                           \
+        return _##prefix##New(valueSize, capacity, false, 0);                          \
+    }                                                                                  \
+                                                                                       \
+    Name prefix##CreateSentinel(size_t valueSize, size_t capacity, KeyType emptyKey) { \
+        return _##prefix##New(valueSize, capacity, true, emptyKey);                    \
+    }                                                                                  \
+                                                                                       \
+    void prefix##Put(Name map, KeyType key, void* value) {                             \
+        if (!map) return;                                                              \
+        if (map->sentinel && key == map->emptyKey) {                                   \
+            void* slot = _##prefix##Value(map, map->capacity);                         \
+            if (!map->hasEmptyKey) {                                                   \
+                map->hasEmptyKey = true;                                               \
+                map->count++;                                                          \
+                if (slot && !value) memset(slot, 0, map->valueSize);                   \
+            }                                                                          \
+            if (slot && value) memcpy(slot, value, map->valueSize);                    \
+            return;                                                                    \
+        }                                                                              \
+        if ((map->count + 1) * INTMAP_LOAD_DEN > map->capacity * INTMAP_LOAD_NUM)      \
+            _##prefix##Resize(map, map->capacity * 2);                                 \
+        _##prefix##Insert(map, key, value);                                            \
+    }                                                                                  \
+                                                                                       \
+    void* prefix##Get(Name map, KeyType key) {                                         \
+        if (!map) return NULL;                                                         \
+        if (map->sentinel && key == map->emptyKey)                                     \
+            return map->hasEmptyKey ? _##prefix##Value(map, map->capacity) : NULL;     \
+        size_t i = _##prefix##Find(map, key);                                          \
+        return i == (size_t)-1 ? NULL : _##prefix##Value(map, i);                      \
+    }                                                                                  \
+                                                                                       \
+    bool prefix##Contains(Name map, KeyType key) {                                     \
+        if (!map) return false;                                                        \
+        if (map->sentinel && key == map->emptyKey) return map->hasEmptyKey;            \
+        return _##prefix##Find(map, key) != (size_t)-1;                                \
+    }                                                                                  \
+                                                                                       \
+    void prefix##Remove(Name map, KeyType key) {                                       \
+        if (!map) return;                                                              \
+        if (map->sentinel && key == map->emptyKey) {                                   \
+            if (map->hasEmptyKey) map->count--;                                        \
+            map->hasEmptyKey = false;                                                  \
+            return;                                                                    \
+        }                                                                              \
+        size_t i = _##prefix##Find(map, key);                                          \
+        if (i == (size_t)-1) return;                                                   \
+                                                                                       \
+        size_t mask = map->capacity - 1;                                               \
+        size_t j = i;                                                                  \
+        for (;;) {                                                                     \
+            j = (j + 1) & mask;                                                        \
+            if (_##prefix##Empty(map, j)) break;                                       \
+            size_t home = _##prefix##Slot(map, map->keys[j]);                          \
+            if (((j - home) & mask) < ((j - i) & mask)) continue;                      \
+            map->keys[i] = map->keys[j];                                               \
+            if (map->valueSize > 0)                                                    \
+                memcpy(_##prefix##Value(map, i), _##prefix##Value(map, j), map->valueSize); \
+            i = j;                                                                     \
+        }                                                                              \
+        if (map->sentinel) map->keys[i] = map->emptyKey;                               \
+        else map->used[i] = 0;                                                         \
+        map->count--;                                                                  \
+    }                                                                                  \
+                                                                                       \
+    void prefix##Reserve(Name map, size_t n) {                                         \
+        if (!map) return;                                                              \
+        size_t capacity = map->capacity;                                               \
+        while (capacity * INTMAP_LOAD_NUM < n * INTMAP_LOAD_DEN) capacity *= 2;        \
+        if (capacity > map->capacity) _##prefix##Resize(map, capacity);                \
+    }                                                                                  \
+                                                                                       \
+    void prefix##Clear(Name map) {                                                     \
+        if (!map) return;                                                              \
+        if (map->sentinel)                                                             \
+            for (size_t i = 0; i < map->capacity; i++) map->keys[i] = map->emptyKey;   \
+        else                                                                           \
+            memset(map->used, 0, map->capacity);                                       \
+        map->hasEmptyKey = false;                                                      \
+        map->count = 0;                                                                \
+    }                                                                                  \
+                                                                                       \
+    void prefix##Free(Name map) {                                                      \
+        if (!map) return;                                                              \
+        xFree(map->keys);                                                              \
+        xFree(map->used);                                                              \
+        xFree(map->values);                                                            \
+        xFree(map);                                                                    \
+    }                                                                                  \
+                                                                                       \
+    Name##Iterator prefix##Iterator(Name map) {                                        \
+        Name##Iterator it = { map, 0 };                                                \
+        return it;                                                                     \
+    }                                                                                  \
+                                                                                       \
+    bool prefix##Next(Name##Iterator* it, KeyType* key, void** value) {                \
+        if (!it || !it->map) return false;                                             \
+        Name map = it->map;                                                            \
+        while (it->index < map->capacity) {                                            \
+            size_t i = it->index++;                                                    \
+            if (_##prefix##Empty(map, i)) continue;                                    \
+            if (key) *key = map->keys[i];                                              \
+            if (value) *value = _##prefix##Value(map, i);                              \
+            return true;                                                               \
+        }                                                                              \
+        if (it->index == map->capacity && map->hasEmptyKey) {                          \
+            it->index++;                                                               \
+            if (key) *key = map->emptyKey;                                             \
+            if (value) *value = _##prefix##Value(map, map->capacity);                  \
+            return true;                                                               \
+        }                                                                              \
+        return false;                                                                  \
+    }
+
+INTMAP_DEFINE(IntMap, intMap, int)
+INTMAP_DEFINE(U64Map, u64Map, uint64_t)
@@ -2,6 +2,11 @@
 #include "../include/pointers.h"
 #include <string.h>
 
+static void* _detachData(void* node, void* data, size_t esize) {
+    memmove(node, data, esize);
+    return node;
+}
+
 SLinkedList sLinkedList(size_t esize) {
     SLinkedList list;
     list.head = NULL;
@@ -12,8 +17,8 @@ SLinkedList sLinkedList(size_t esize) {
 }
 
 void sLinkedListPushFront(SLinkedList* list, void* value) {
-    SLinkedListNode* node = xMalloc(sizeof(SLinkedListNode));
-    node->data = xMalloc(list->esize);
+    SLinkedListNode* node = xMalloc(sizeof(SLinkedListNode) + list->esize);
+    node->data = node->storage;
     memcpy(node->data, value, list->esize);
     node->next = list->head;
     list->head = node;
@@ -23,8 +28,8 @@ void sLinkedListPushFront(SLinkedList* list, void* value) {
 }
 
 void sLinkedListPushBack(SLinkedList* list, void* value) {
-    SLinkedListNode* node = xMalloc(sizeof(SLinkedListNode));
-    node->data = xMalloc(list->esize);
+    SLinkedListNode* node = xMalloc(sizeof(SLinkedListNode) + list->esize);
+    node->data = node->storage;
     memcpy(node->data, value, list->esize);
     node->next = NULL;
     if (list->tail == NULL) {
@@ -49,8 +54,8 @@ void sLinkedListInsertAt(SLinkedList* list, void* value, size_t index) {
     SLinkedListNode* current = list->head;
     for (size_t i = 0; i < index - 1; i++)
         current = current->next;
-    SLinkedListNode* node = xMalloc(sizeof(SLinkedListNode));
-    node->data = xMalloc(list->esize);
+    SLinkedListNode* node = xMalloc(sizeof(SLinkedListNode) + list->esize);
+    node->data = node->storage;
     memcpy(node->data, value, list->esize);
     node->next = current->next;
     current->next = node;
@@ -74,7 +79,6 @@ void sLinkedListFree(SLinkedList* list, void (*freeFn)(void*)) {
         if (freeFn != NULL) {
             freeFn(tmp->data);
         }
-        xFree(tmp->data);
         xFree(tmp);
     }
     list->head = NULL;
@@ -128,8 +132,8 @@ DLinkedList dLinkedList(size_t esize) {
 }
 
 void dLinkedListPushFront(DLinkedList* list, void* value) {
-    DLinkedListNode* node = xMalloc(sizeof(DLinkedListNode));
-    node->data = xMalloc(list->esize);
+    DLinkedListNode* node = xMalloc(sizeof(DLinkedListNode) + list->esize);
+    node->data = node->storage;
     memcpy(node->data, value, list->esize);
     node->previous = NULL;
     node->next = list->head;
@@ -142,8 +146,8 @@ void dLinkedListPushFront(DLinkedList* list, void* value) {
 }
 
 void dLinkedListPushBack(DLinkedList* list, void* value) {
-    DLinkedListNode* node = xMalloc(sizeof(DLinkedListNode));
-    node->data = xMalloc(list->esize);
+    DLinkedListNode* node = xMalloc(sizeof(DLinkedListNode) + list->esize);
+    node->data = node->storage;
     memcpy(node->data, value, list->esize);
     node->next = NULL;
     node->previous = list->tail;
@@ -174,8 +178,8 @@ void dLinkedListInsertAt(DLinkedList* list, void* value, size_t index) {
         for (size_t i = list->len - 1; i > index; i--)
             current = current->previous;
     }
-    DLinkedListNode* node = xMalloc(sizeof(DLinkedListNode));
-    node->data = xMalloc(list->esize);
+    DLinkedListNode* node = xMalloc(sizeof(DLinkedListNode) + list->esize);
+    node->data = node->storage;
     memcpy(node->data, value, list->esize);
     node->previous = current->previous;
     node->next = current;
@@ -208,7 +212,6 @@ void dLinkedListFree(DLinkedList* list, void (*freeFn)(void*)) {
         if (freeFn != NULL) {
             freeFn(tmp->data);
         }
-        xFree(tmp->data);
         xFree(tmp);
     }
     list->head = NULL;
@@ -273,8 +276,6 @@ void sLinkedListRemoveAt(SLinkedList* list, size_t index) {
             list->tail = current;
         }
     }
-
-    xFree(toDelete->data);
     xFree(toDelete);
     list->len--;
 }
@@ -296,15 +297,13 @@ void* sLinkedListPopFront(SLinkedList* list) {
     if (list->len == 0) return NULL;
     
     SLinkedListNode* toDelete = list->head;
-    void* data = toDelete->data; 
     
     list->head = list->head->next;
     if (list->len == 1) list->tail = NULL;
     
-    xFree(toDelete); 
     list->len--;
     
-    return data; 
+    return _detachData(toDelete, toDelete->data, list->esize); 
 }
 
 void dLinkedListRemoveAt(DLinkedList* list, size_t index) {
@@ -333,8 +332,6 @@ void dLinkedListRemoveAt(DLinkedList* list, size_t index) {
         toDelete->previous->next = toDelete->next;
         toDelete->next->previous = toDelete->previous;
     }
-
-    xFree(toDelete->data);
     xFree(toDelete);
     list->len--;
 }
@@ -356,16 +353,14 @@ void* dLinkedListPopFront(DLinkedList* list) {
     if (list->len == 0) return NULL;
 
     DLinkedListNode* toDelete = list->head;
-    void* data = toDelete->data;
 
     list->head = list->head->next;
     if (list->head) list->head->previous = NULL;
     else list->tail = NULL;
 
-    xFree(toDelete);
     list->len--;
 
-    return data;
+    return _detachData(toDelete, toDelete->data, list->esize);
 }
 
 static SLinkedListNode* sListMerge(SLinkedListNode* a, SLinkedListNode* b, int (*cmp)(const void*, const void*)) {
@@ -416,8 +411,8 @@ SLinkedList arrayToSLinkedList(Array arr) {
     if (arr->len == 0) return list;
 
     char* ptr = (char*)arr->data;
-    SLinkedListNode* node = xMalloc(sizeof(SLinkedListNode));
-    node->data = xMalloc(arr->esize);
+    SLinkedListNode* node = xMalloc(sizeof(SLinkedListNode) + arr->esize);
+    node->data = node->storage;
     memcpy(node->data, ptr, arr->esize);
     node->next = NULL;
     
@@ -426,8 +421,8 @@ SLinkedList arrayToSLinkedList(Array arr) {
     list.len++;
     for (size_t i = 1; i < arr->len; i++) {
         ptr += arr->esize;
-        SLinkedListNode* newNode = xMalloc(sizeof(SLinkedListNode));
-        newNode->data = xMalloc(arr->esize);
+        SLinkedListNode* newNode = xMalloc(sizeof(SLinkedListNode) + arr->esize);
+        newNode->data = newNode->storage;
         memcpy(newNode->data, ptr, arr->esize);
         newNode->next = NULL;
         
@@ -500,8 +495,8 @@ DLinkedList arrayToDLinkedList(Array arr) {
 
     char* ptr = (char*)arr->data;
 
-    DLinkedListNode* node = xMalloc(sizeof(DLinkedListNode));
-    node->data = xMalloc(arr->esize);
+    DLinkedListNode* node = xMalloc(sizeof(DLinkedListNode) + arr->esize);
+    node->data = node->storage;
     memcpy(node->data, ptr, arr->esize);
     node->next = NULL;
     node->previous = NULL;
@@ -512,8 +507,8 @@ DLinkedList arrayToDLinkedList(Array arr) {
 
     for (size_t i = 1; i < arr->len; i++) {
         ptr += arr->esize;
-        DLinkedListNode* newNode = xMalloc(sizeof(DLinkedListNode));
-        newNode->data = xMalloc(arr->esize);
+        DLinkedListNode* newNode = xMalloc(sizeof(DLinkedListNode) + arr->esize);
+        newNode->data = newNode->storage;
         memcpy(newNode->data, ptr, arr->esize);
         
         newNode->next = NULL;
@@ -1,27 +1,155 @@
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "../include/maps.h"
 #include "../include/pointers.h"
 #include "../include/strings.h"
 
-static uint32_t _fnv1a(const void* data, size_t size) {
-    uint32_t hash = 2166136261u;
-    const unsigned char* p = (const unsigned char*)data;
-    for (size_t i = 0; i < size; i++) {
-        hash ^= p[i];
-        hash *= 16777619;
+static const uint64_t _wyp[4] = {
+    0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+    0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+};
+
+static uint64_t _seedBase = 0;
+static atomic_uint_fast64_t _seedCounter = 0;
+
+__attribute__((constructor))
+static void _initHashSeed(void) {
+#ifdef __linux__
+    if (getentropy(&_seedBase, sizeof(_seedBase)) == 0) return;
+#endif
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    _seedBase = (uint64_t)ts.tv_nsec ^ ((uint64_t)ts.tv_sec << 32) ^ (uint64_t)(uintptr_t)&ts;
+}
+
+static inline uint64_t _mum(uint64_t a, uint64_t b) {
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+static inline uint64_t _read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t _read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t _hashWord(uint64_t x, uint64_t seed) {
+    return _mum(_mum(x ^ seed, _wyp[0]) ^ _wyp[1], seed ^ _wyp[2]);
+}
+
+uint64_t hashSeed(void) {
+    uint64_t z = _seedBase + atomic_fetch_add_explicit(&_seedCounter, 0x9e3779b97f4a7c15ull, memory_order_relaxed);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+uint64_t hashBytes(const void* data, size_t len, uint64_t seed) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint64_t a, b;
+    seed ^= _mum(seed ^ _wyp[0], _wyp[1]);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (_read32(p) << 32) | _read32(p + ((len >> 3) << 2));
+            b = (_read32(p + len - 4) << 32) | _read32(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t s1 = seed, s2 = seed;
+            do {
+                seed = _mum(_read64(p) ^ _wyp[1], _read64(p + 8) ^ seed);
+                s1 = _mum(_read64(p + 16) ^ _wyp[2], _read64(p + 24) ^ s1);
+                s2 = _mum(_read64(p + 32) ^ _wyp[3], _read64(p + 40) ^ s2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= s1 ^ s2;
+        }
+        while (i > 16) {
+            seed = _mum(_read64(p) ^ _wyp[1], _read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = _read64(p + i - 16);
+        b = _read64(p + i - 8);
     }
-    return hash;
+
+    __uint128_t r = (__uint128_t)(a ^ _wyp[1]) * (b ^ seed);
+    return _mum((uint64_t)r ^ _wyp[0] ^ len, (uint64_t)(r >> 64) ^ _wyp[1]);
+}
+
+uint64_t hashInt(const void* key, size_t size, uint64_t seed) {
+    if (size == sizeof(uint32_t)) return _hashWord(_read32((const uint8_t*)key), seed);
+    if (size == sizeof(uint64_t)) return _hashWord(_read64((const uint8_t*)key), seed);
+    return hashBytes(key, size, seed);
 }
 
-uint32_t hashInt(const void* key, size_t size) {
-    return _fnv1a(key, size);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define _HAS_ZERO(v) (((v) - 0x0101010101010101ull) & ~(v) & 0x8080808080808080ull)
+
+__attribute__((no_sanitize_address))
+uint64_t hashString(const void* key, size_t size, uint64_t seed) {
+    (void)size;
+    uintptr_t addr = (uintptr_t)key;
+    unsigned shift = (unsigned)(addr & 7) * 8;
+    const uint64_t* wp = (const uint64_t*)(addr & ~(uintptr_t)7);
+    uint64_t cur = *wp++;
+    uint64_t h = seed ^ _wyp[0];
+    size_t len = 0;
+
+    for (;;) {
+        uint64_t zero = _HAS_ZERO(cur | (shift ? (1ull << shift) - 1 : 0));
+        uint64_t chunk;
+        if (zero) {
+            chunk = cur >> shift;
+            zero >>= shift;
+        } else {
+            uint64_t next = *wp++;
+            chunk = shift ? (cur >> shift) | (next << (64 - shift)) : cur;
+            cur = next;
+            zero = _HAS_ZERO(chunk);
+        }
+
+        if (zero) {
+            unsigned tail = (unsigned)__builtin_ctzll(zero) / 8;
+            chunk &= tail ? (~0ull >> (64 - tail * 8)) : 0;
+            len += tail;
+            return _mum(h ^ chunk ^ _wyp[2], len ^ _wyp[3]);
+        }
+
+        h = _mum(chunk ^ _wyp[1], h);
+        len += 8;
+    }
 }
 
-uint32_t hashString(const void* key, size_t size) {
+#undef _HAS_ZERO
+#else
+uint64_t hashString(const void* key, size_t size, uint64_t seed) {
     (void)size;
-    return _fnv1a(key, strlen((const char*)key));
+    return hashBytes(key, strlen((const char*)key), seed);
 }
+#endif
 
 bool keyEqualsInt(const void* k1, const void* k2, size_t size) {
     return memcmp(k1, k2, size) == 0;
@@ -32,38 +160,242 @@ bool keyEqualsString(const void* k1, const void* k2, size_t size) {
     return strcmp((const char*)k1, (const char*)k2) == 0;
 }
 
-HashMap mapCreate(size_t keySize, size_t valueSize, size_t capacity) {
-    HashMap map = (HashMap)xMalloc(sizeof(HashMapStruct));
+#define MAP_MIN_CAPACITY   8
+#define MAP_LOAD_NUM       3
+#define MAP_LOAD_DEN       4
+#define MAP_REHASH_STEP    8
+#define MAP_BATCH          16
+
+#define SWISS_GROUP        16
+#define SWISS_ALIGN        8
+#define SWISS_EMPTY        ((uint8_t)0x80)
+#define SWISS_DELETED      ((uint8_t)0xFE)
+#define SWISS_NONE         ((size_t)-1)
+#define SWISS_ENTRY_KEY    sizeof(uint64_t)
+#define MAP_HASH_LIVE      (1ull << 63)
+
+#ifdef MAP_PROBE_STATS
+#define _PROBE_BEGIN(n)        size_t n = 0
+#define _PROBE_STEP(n)         ((n)++)
+#define _PROBE_END(map, n)     _probeRecord(map, n)
+#else
+#define _PROBE_BEGIN(n)        ((void)0)
+#define _PROBE_STEP(n)         ((void)0)
+#define _PROBE_END(map, n)     ((void)0)
+#endif
+
+typedef struct {
+    uint64_t hash;
+    size_t len;
+    char data[];
+} MapStrKey;
+
+typedef struct {
+    const void* key;
+    size_t len;
+    uint64_t hash;
+} MapProbe;
+
+static inline MapStrKey* _strKeyOf(const void* key) {
+    return (MapStrKey*)((char*)key - offsetof(MapStrKey, data));
+}
+
+static inline MapProbe _probeStr(HashMap map, const char* key, size_t len) {
+    MapProbe probe = { key, len, hashBytes(key, len, map->seed) | MAP_HASH_LIVE };
+    return probe;
+}
+
+static inline MapProbe _probeOf(HashMap map, const void* key) {
+    if (map->strKeys) return _probeStr(map, (const char*)key, strlen((const char*)key));
+    MapProbe probe = { key, map->keySize, map->hashFunc(key, map->keySize, map->seed) | MAP_HASH_LIVE };
+    return probe;
+}
+
+static inline bool _keyMatches(HashMap map, const void* stored, const MapProbe* probe) {
+    if (map->strKeys) {
+        const MapStrKey* k = _strKeyOf(stored);
+        return k->hash == probe->hash && k->len == probe->len && memcmp(k->data, probe->key, probe->len) == 0;
+    }
+    return map->keyEquals(probe->key, stored, map->keySize);
+}
+
+static inline uint64_t _keyHash(HashMap map, const void* stored) {
+    if (map->strKeys) return _strKeyOf(stored)->hash;
+    return map->hashFunc(stored, map->keySize, map->seed) | MAP_HASH_LIVE;
+}
+
+static void* _keyNew(HashMap map, const MapProbe* probe) {
+    if (map->strKeys) {
+        MapStrKey* k = (MapStrKey*)xMalloc(sizeof(MapStrKey) + probe->len + 1);
+        k->hash = probe->hash;
+        k->len = probe->len;
+        memcpy(k->data, probe->key, probe->len);
+        k->data[probe->len] = '\0';
+        return k->data;
+    }
+    void* k = xMalloc(map->keySize);
+    memcpy(k, probe->key, map->keySize);
+    return k;
+}
+
+static void _keyRelease(HashMap map, void* key, void (*keyFree)(void*)) {
+    if (keyFree) keyFree(key);
+    if (map->strKeys) xFree(_strKeyOf(key));
+    else if (map->engine == MAP_ENGINE_CHAINED) xFree(key);
+}
+
+static void _orderAppend(HashMap map, MapEntry* entry) {
+    if (map->entryCount == map->entryCapacity) {
+        size_t live = 0;
+        for (size_t i = 0; i < map->entryCount; i++) {
+            MapEntry* current = map->order[i];
+            if (!current) continue;
+            current->order = live;
+            map->order[live++] = current;
+        }
+        map->entryCount = live;
+        if (live * 2 >= map->entryCapacity) {
+            map->entryCapacity = map->entryCapacity ? map->entryCapacity * 2 : MAP_MIN_CAPACITY;
+            map->order = (MapEntry**)xRealloc(map->order, map->entryCapacity * sizeof(MapEntry*));
+        }
+    }
+    entry->order = map->entryCount;
+    map->order[map->entryCount++] = entry;
+}
+
+static void _entryFree(HashMap map, MapEntry* entry, void (*keyFree)(void*), void (*valFree)(void*)) {
+    _keyRelease(map, entry->key, keyFree);
+
+    if (entry->value) {
+        if (valFree) valFree(entry->value);
+        xFree(entry->value);
+    }
+
+    xFree(entry);
+}
+
+static void _rehashStep(HashMap map, size_t maxBuckets) {
+    if (!map->oldBuckets) return;
+
+    size_t moved = 0;
+    size_t visits = maxBuckets * 10;
+    while (moved < maxBuckets && visits > 0 && map->rehashIndex < map->oldCapacity) {
+        MapEntry* current = map->oldBuckets[map->rehashIndex];
+        if (!current) {
+            map->rehashIndex++;
+            visits--;
+            continue;
+        }
+        while (current) {
+            MapEntry* next = current->next;
+            size_t index = _keyHash(map, current->key) % map->capacity;
+            current->next = map->buckets[index];
+            map->buckets[index] = current;
+            current = next;
+        }
+        map->oldBuckets[map->rehashIndex++] = NULL;
+        moved++;
+    }
+
+    if (map->rehashIndex >= map->oldCapacity) {
+        xFree(map->oldBuckets);
+        map->oldBuckets = NULL;
+        map->oldCapacity = 0;
+        map->rehashIndex = 0;
+    }
+}
+
+static void _rehashBegin(HashMap map, size_t capacity) {
+    if (map->oldBuckets) mapRehashFinish(map);
+    map->oldBuckets = map->buckets;
+    map->oldCapacity = map->capacity;
+    map->rehashIndex = 0;
     map->buckets = (MapEntry**)xCalloc(capacity, sizeof(MapEntry*));
     map->capacity = capacity;
-    map->count = 0;
-    map->keySize = keySize;
-    map->valueSize = valueSize;
-    map->hashFunc = hashInt; 
-    map->keyEquals = keyEqualsInt;
-    return map;
 }
 
-void mapPut(HashMap map, void* key, void* value) {
-    if (!map) return;
+static bool _overloaded(size_t count, size_t capacity) {
+    return count * MAP_LOAD_DEN > capacity * MAP_LOAD_NUM;
+}
+
+#ifdef MAP_PROBE_STATS
+static inline void _probeRecord(HashMap map, size_t probes) {
+    map->probes += probes;
+    map->lookups++;
+    if (probes > map->maxLookupProbes) map->maxLookupProbes = probes;
+}
+#endif
+
+static MapEntry* _findEntry(HashMap map, const MapProbe* probe) {
+    _PROBE_BEGIN(probes);
+    MapEntry* current = map->buckets[probe->hash % map->capacity];
+    while (current) {
+        _PROBE_STEP(probes);
+        if (_keyMatches(map, current->key, probe)) {
+            _PROBE_END(map, probes);
+            return current;
+        }
+        current = current->next;
+    }
 
-    uint32_t hash = map->hashFunc(key, map->keySize);
-    size_t index = hash % map->capacity;
+    if (map->oldBuckets) {
+        current = map->oldBuckets[probe->hash % map->oldCapacity];
+        while (current) {
+            _PROBE_STEP(probes);
+            if (_keyMatches(map, current->key, probe)) {
+                _PROBE_END(map, probes);
+                return current;
+            }
+            current = current->next;
+        }
+    }
+    _PROBE_END(map, probes);
+    return NULL;
+}
 
-    MapEntry* current = map->buckets[index];
+static MapEntry* _unlinkEntry(HashMap map, MapEntry** buckets, size_t index, const MapProbe* probe) {
+    MapEntry* current = buckets[index];
+    MapEntry* prev = NULL;
 
     while (current) {
-        if (map->keyEquals(key, current->key, map->keySize)) {
-            if (value && map->valueSize > 0)
-                memcpy(current->value, value, map->valueSize);
-            return;
+        if (_keyMatches(map, current->key, probe)) {
+            if (prev) {
+                prev->next = current->next;
+            } else {
+                buckets[index] = current->next;
+            }
+            return current;
         }
+        prev = current;
         current = current->next;
     }
+    return NULL;
+}
+
+static void _clearBuckets(HashMap map, MapEntry** buckets, size_t capacity, void (*keyFree)(void*), void (*valFree)(void*)) {
+    for (size_t i = 0; i < capacity; i++) {
+        MapEntry* current = buckets[i];
+        while (current) {
+            MapEntry* next = current->next;
+            _entryFree(map, current, keyFree, valFree);
+            current = next;
+        }
+        buckets[i] = NULL;
+    }
+}
+
+static void _chainedPut(HashMap map, const MapProbe* probe, void* value) {
+    _rehashStep(map, MAP_REHASH_STEP);
+
+    MapEntry* current = _findEntry(map, probe);
+    if (current) {
+        if (value && map->valueSize > 0)
+            memcpy(current->value, value, map->valueSize);
+        return;
+    }
 
     MapEntry* newEntry = (MapEntry*)xMalloc(sizeof(MapEntry));
-    newEntry->key = xMalloc(map->keySize);
-    memcpy(newEntry->key, key, map->keySize);
+    newEntry->key = _keyNew(map, probe);
 
     if (map->valueSize > 0 && value) {
         newEntry->value = xMalloc(map->valueSize);
@@ -72,39 +404,361 @@ void mapPut(HashMap map, void* key, void* value) {
         newEntry->value = NULL;
     }
 
+    size_t index = probe->hash % map->capacity;
     newEntry->next = map->buckets[index];
     map->buckets[index] = newEntry;
+    _orderAppend(map, newEntry);
     map->count++;
+
+    if (!map->oldBuckets && _overloaded(map->count, map->capacity))
+        _rehashBegin(map, map->capacity * 2);
 }
 
-void* mapGet(HashMap map, void* key) {
-    if (!map) return NULL;
-    uint32_t hash = map->hashFunc(key, map->keySize);
-    size_t index = hash % map->capacity;
+static void _chainedRemove(HashMap map, const MapProbe* probe, void (*keyFree)(void*), void (*valFree)(void*)) {
+    _rehashStep(map, MAP_REHASH_STEP);
 
-    MapEntry* current = map->buckets[index];
-    while (current) {
-        if (map->keyEquals(key, current->key, map->keySize)) {
-            return current->value;
+    MapEntry* entry = _unlinkEntry(map, map->buckets, probe->hash % map->capacity, probe);
+    if (!entry && map->oldBuckets)
+        entry = _unlinkEntry(map, map->oldBuckets, probe->hash % map->oldCapacity, probe);
+    if (!entry) return;
+
+    map->order[entry->order] = NULL;
+    _entryFree(map, entry, keyFree, valFree);
+    map->count--;
+}
+
+static size_t _swissCapacityFor(size_t n) {
+    size_t capacity = SWISS_GROUP;
+    while (capacity - capacity / 8 < n) capacity *= 2;
+    return capacity;
+}
+
+static inline uint32_t _groupMatch(const uint8_t* group, uint8_t b) {
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)b)));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < SWISS_GROUP; i++)
+        if (group[i] == b) mask |= 1u << i;
+    return mask;
+#endif
+}
+
+static inline uint32_t _groupMatchFree(const uint8_t* group) {
+#ifdef __SSE2__
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < SWISS_GROUP; i++)
+        if (group[i] & 0x80) mask |= 1u << i;
+    return mask;
+#endif
+}
+
+static inline uint8_t* _entryAt(HashMap map, size_t index) {
+    return map->entries + index * map->entrySize;
+}
+
+static inline uint64_t _entryHash(const uint8_t* entry) {
+    return *(const uint64_t*)entry;
+}
+
+static inline void* _entryKey(HashMap map, uint8_t* entry) {
+    return map->strKeys ? *(void**)(entry + SWISS_ENTRY_KEY) : (void*)(entry + SWISS_ENTRY_KEY);
+}
+
+static inline void* _entryValue(HashMap map, uint8_t* entry) {
+    return map->valueSize > 0 ? entry + map->valueOffset : NULL;
+}
+
+static void _swissAlloc(HashMap map, size_t capacity) {
+    map->ctrl = (uint8_t*)xMalloc(capacity);
+    memset(map->ctrl, SWISS_EMPTY, capacity);
+    map->index = (uint32_t*)xMalloc(capacity * sizeof(uint32_t));
+    map->capacity = capacity;
+    map->growthLeft = capacity - capacity / 8;
+}
+
+static size_t _swissFind(HashMap map, const MapProbe* probe) {
+    size_t groupMask = map->capacity / SWISS_GROUP - 1;
+    size_t group = (probe->hash >> 7) & groupMask;
+    uint8_t h2 = (uint8_t)(probe->hash & 0x7F);
+    _PROBE_BEGIN(probes);
+
+    for (size_t step = 1; ; step++) {
+        const uint8_t* ctrl = map->ctrl + group * SWISS_GROUP;
+        uint32_t match = _groupMatch(ctrl, h2);
+        _PROBE_STEP(probes);
+        while (match) {
+            size_t slot = group * SWISS_GROUP + (size_t)__builtin_ctz(match);
+            uint8_t* entry = _entryAt(map, map->index[slot]);
+            if (_entryHash(entry) == probe->hash && _keyMatches(map, _entryKey(map, entry), probe)) {
+                _PROBE_END(map, probes);
+                return slot;
+            }
+            match &= match - 1;
         }
-        current = current->next;
+        if (_groupMatch(ctrl, SWISS_EMPTY)) {
+            _PROBE_END(map, probes);
+            return SWISS_NONE;
+        }
+        group = (group + step) & groupMask;
     }
-    return NULL;
 }
 
-void* mapGetKey(HashMap map, void* key) {
-    if (!map) return NULL;
-    uint32_t hash = map->hashFunc(key, map->keySize);
-    size_t index = hash % map->capacity;
+static size_t _swissFindFree(HashMap map, uint64_t hash) {
+    size_t groupMask = map->capacity / SWISS_GROUP - 1;
+    size_t group = (hash >> 7) & groupMask;
 
-    MapEntry* current = map->buckets[index];
-    while (current) {
-        if (map->keyEquals(key, current->key, map->keySize)) {
-            return current->key;
+    for (size_t step = 1; ; step++) {
+        uint32_t free = _groupMatchFree(map->ctrl + group * SWISS_GROUP);
+        if (free) return group * SWISS_GROUP + (size_t)__builtin_ctz(free);
+        group = (group + step) & groupMask;
+    }
+}
+
+static void _swissRebuild(HashMap map, size_t capacity) {
+    xFree(map->ctrl);
+    xFree(map->index);
+    _swissAlloc(map, capacity);
+
+    size_t entryCapacity = capacity - capacity / 8;
+    if (entryCapacity > map->entryCapacity) {
+        map->entries = (uint8_t*)xRealloc(map->entries, entryCapacity * map->entrySize);
+        map->entryCapacity = entryCapacity;
+    }
+
+    size_t live = 0;
+    for (size_t i = 0; i < map->entryCount; i++) {
+        uint8_t* entry = _entryAt(map, i);
+        uint64_t hash = _entryHash(entry);
+        if (!hash) continue;
+        if (live != i) memcpy(_entryAt(map, live), entry, map->entrySize);
+
+        size_t slot = _swissFindFree(map, hash);
+        map->ctrl[slot] = (uint8_t)(hash & 0x7F);
+        map->index[slot] = (uint32_t)live;
+        live++;
+    }
+    map->entryCount = live;
+    map->growthLeft -= live;
+}
+
+static void _swissPut(HashMap map, const MapProbe* probe, void* value) {
+    size_t slot = _swissFind(map, probe);
+    if (slot != SWISS_NONE) {
+        if (value && map->valueSize > 0)
+            memcpy(_entryValue(map, _entryAt(map, map->index[slot])), value, map->valueSize);
+        return;
+    }
+
+    if (map->growthLeft == 0 || map->entryCount == map->entryCapacity) {
+        size_t maxLoad = map->capacity - map->capacity / 8;
+        _swissRebuild(map, map->count * 2 > maxLoad ? map->capacity * 2 : map->capacity);
+    }
+
+    slot = _swissFindFree(map, probe->hash);
+    if (map->ctrl[slot] == SWISS_EMPTY) map->growthLeft--;
+    map->ctrl[slot] = (uint8_t)(probe->hash & 0x7F);
+    map->index[slot] = (uint32_t)map->entryCount;
+
+    uint8_t* entry = _entryAt(map, map->entryCount++);
+    *(uint64_t*)entry = probe->hash;
+    if (map->strKeys) *(void**)(entry + SWISS_ENTRY_KEY) = _keyNew(map, probe);
+    else memcpy(entry + SWISS_ENTRY_KEY, probe->key, map->keySize);
+    if (map->valueSize > 0) {
+        if (value) memcpy(entry + map->valueOffset, value, map->valueSize);
+        else memset(entry + map->valueOffset, 0, map->valueSize);
+    }
+    map->count++;
+}
+
+static void _swissRemove(HashMap map, const MapProbe* probe, void (*keyFree)(void*), void (*valFree)(void*)) {
+    size_t slot = _swissFind(map, probe);
+    if (slot == SWISS_NONE) return;
+
+    uint8_t* entry = _entryAt(map, map->index[slot]);
+    _keyRelease(map, _entryKey(map, entry), keyFree);
+    if (valFree && map->valueSize > 0) valFree(entry + map->valueOffset);
+    *(uint64_t*)entry = 0;
+
+    if (_groupMatch(map->ctrl + (slot & ~(size_t)(SWISS_GROUP - 1)), SWISS_EMPTY)) {
+        map->ctrl[slot] = SWISS_EMPTY;
+        map->growthLeft++;
+    } else {
+        map->ctrl[slot] = SWISS_DELETED;
+    }
+    map->count--;
+}
+
+static void _swissClear(HashMap map, void (*keyFree)(void*), void (*valFree)(void*)) {
+    if (keyFree || valFree || map->strKeys) {
+        for (size_t i = 0; i < map->entryCount; i++) {
+            uint8_t* entry = _entryAt(map, i);
+            if (!_entryHash(entry)) continue;
+            _keyRelease(map, _entryKey(map, entry), keyFree);
+            if (valFree && map->valueSize > 0) valFree(entry + map->valueOffset);
         }
-        current = current->next;
     }
-    return NULL;
+    memset(map->ctrl, SWISS_EMPTY, map->capacity);
+    map->growthLeft = map->capacity - map->capacity / 8;
+    map->entryCount = 0;
+}
+
+static void _put(HashMap map, const MapProbe* probe, void* value) {
+    if (map->engine == MAP_ENGINE_SWISS) _swissPut(map, probe, value);
+    else _chainedPut(map, probe, value);
+}
+
+static void* _lookup(HashMap map, const MapProbe* probe, void** value) {
+    if (map->engine == MAP_ENGINE_SWISS) {
+        size_t slot = _swissFind(map, probe);
+        if (slot == SWISS_NONE) return NULL;
+        uint8_t* entry = _entryAt(map, map->index[slot]);
+        *value = _entryValue(map, entry);
+        return _entryKey(map, entry);
+    }
+
+    MapEntry* entry = _findEntry(map, probe);
+    if (!entry) return NULL;
+    *value = entry->value;
+    return entry->key;
+}
+
+static void* _getKey(HashMap map, const MapProbe* probe, void** value) {
+    if (map->engine == MAP_ENGINE_CHAINED) _rehashStep(map, MAP_REHASH_STEP);
+    return _lookup(map, probe, value);
+}
+
+static inline void _prefetchSlot(HashMap map, const MapProbe* probe) {
+    if (map->engine == MAP_ENGINE_SWISS) {
+        size_t group = (probe->hash >> 7) & (map->capacity / SWISS_GROUP - 1);
+        __builtin_prefetch(map->ctrl + group * SWISS_GROUP);
+        __builtin_prefetch(map->index + group * SWISS_GROUP);
+    } else {
+        __builtin_prefetch(&map->buckets[probe->hash % map->capacity]);
+    }
+}
+
+static inline void _prefetchEntry(HashMap map, const MapProbe* probe) {
+    if (map->engine == MAP_ENGINE_SWISS) {
+        size_t group = (probe->hash >> 7) & (map->capacity / SWISS_GROUP - 1);
+        uint32_t match = _groupMatch(map->ctrl + group * SWISS_GROUP, (uint8_t)(probe->hash & 0x7F));
+        if (match) __builtin_prefetch(_entryAt(map, map->index[group * SWISS_GROUP + (size_t)__builtin_ctz(match)]));
+    } else {
+        MapEntry* entry = map->buckets[probe->hash % map->capacity];
+        if (entry) __builtin_prefetch(entry);
+    }
+}
+
+static size_t _getBatch(HashMap map, const void* keys, size_t n, void** values, bool* hits) {
+    if (map->engine == MAP_ENGINE_CHAINED) _rehashStep(map, MAP_REHASH_STEP);
+
+    MapProbe probes[MAP_BATCH];
+    const uint8_t* base = (const uint8_t*)keys;
+    size_t found = 0;
+
+    for (size_t start = 0; start < n; start += MAP_BATCH) {
+        size_t len = n - start < MAP_BATCH ? n - start : MAP_BATCH;
+        for (size_t i = 0; i < len; i++) {
+            const void* key = base + (start + i) * map->keySize;
+            probes[i] = _probeOf(map, map->strKeys ? *(const char* const*)key : key);
+            _prefetchSlot(map, &probes[i]);
+        }
+        for (size_t i = 0; i < len; i++) _prefetchEntry(map, &probes[i]);
+        for (size_t i = 0; i < len; i++) {
+            void* value = NULL;
+            bool hit = _lookup(map, &probes[i], &value) != NULL;
+            if (values) values[start + i] = value;
+            if (hits) hits[start + i] = hit;
+            found += hit;
+        }
+    }
+    return found;
+}
+
+static void _remove(HashMap map, const MapProbe* probe, void (*keyFree)(void*), void (*valFree)(void*)) {
+    if (map->engine == MAP_ENGINE_SWISS) _swissRemove(map, probe, keyFree, valFree);
+    else _chainedRemove(map, probe, keyFree, valFree);
+}
+
+HashMap mapCreate(size_t keySize, size_t valueSize, size_t capacity) {
+    return mapCreateWithEngine(keySize, valueSize, capacity, MAP_DEFAULT_ENGINE);
+}
+
+HashMap mapCreateWithEngine(size_t keySize, size_t valueSize, size_t capacity, MapEngine engine) {
+    HashMap map = (HashMap)xMalloc(sizeof(HashMapStruct));
+    map->engine = engine;
+    map->count = 0;
+    map->keySize = keySize;
+    map->valueSize = valueSize;
+    map->hashFunc = hashInt; 
+    map->keyEquals = keyEqualsInt;
+    map->seed = hashSeed();
+    map->strKeys = false;
+    map->buckets = NULL;
+    map->oldBuckets = NULL;
+    map->oldCapacity = 0;
+    map->rehashIndex = 0;
+    map->ctrl = NULL;
+    map->index = NULL;
+    map->entries = NULL;
+    map->order = NULL;
+    map->entryCount = 0;
+    map->entryCapacity = 0;
+    map->entrySize = 0;
+    map->valueOffset = 0;
+    map->growthLeft = 0;
+    map->probes = 0;
+    map->lookups = 0;
+    map->maxLookupProbes = 0;
+
+    if (engine == MAP_ENGINE_SWISS) {
+        map->valueOffset = SWISS_ENTRY_KEY + ((keySize + SWISS_ALIGN - 1) & ~(size_t)(SWISS_ALIGN - 1));
+        map->entrySize = (map->valueOffset + valueSize + SWISS_ALIGN - 1) & ~(size_t)(SWISS_ALIGN - 1);
+        _swissAlloc(map, _swissCapacityFor(capacity));
+        map->entryCapacity = map->growthLeft;
+        map->entries = (uint8_t*)xMalloc(map->entryCapacity * map->entrySize);
+    } else {
+        if (capacity < MAP_MIN_CAPACITY) capacity = MAP_MIN_CAPACITY;
+        map->buckets = (MapEntry**)xCalloc(capacity, sizeof(MapEntry*));
+        map->capacity = capacity;
+    }
+    return map;
+}
+
+HashMap mapCreateStr(size_t valueSize, size_t capacity) {
+    return mapCreateStrWithEngine(valueSize, capacity, MAP_DEFAULT_ENGINE);
+}
+
+HashMap mapCreateStrWithEngine(size_t valueSize, size_t capacity, MapEngine engine) {
+    HashMap map = mapCreateWithEngine(sizeof(char*), valueSize, capacity, engine);
+    map->hashFunc = hashString;
+    map->keyEquals = keyEqualsString;
+    map->strKeys = true;
+    return map;
+}
+
+void mapPut(HashMap map, void* key, void* value) {
+    if (!map) return;
+    MapProbe probe = _probeOf(map, key);
+    _put(map, &probe, value);
+}
+
+void* mapGet(HashMap map, void* key) {
+    if (!map) return NULL;
+    MapProbe probe = _probeOf(map, key);
+    void* value = NULL;
+    _getKey(map, &probe, &value);
+    return value;
+}
+
+void* mapGetKey(HashMap map, void* key) {
+    if (!map) return NULL;
+    MapProbe probe = _probeOf(map, key);
+    void* value;
+    return _getKey(map, &probe, &value);
 }
 
 bool mapContains(HashMap map, void* key) {
@@ -113,57 +767,201 @@ bool mapContains(HashMap map, void* key) {
 
 void mapRemove(HashMap map, void* key, void (*keyFree)(void*), void (*valFree)(void*)) {
     if (!map) return;
-    uint32_t hash = map->hashFunc(key, map->keySize);
-    size_t index = hash % map->capacity;
+    MapProbe probe = _probeOf(map, key);
+    _remove(map, &probe, keyFree, valFree);
+}
 
-    MapEntry* current = map->buckets[index];
-    MapEntry* prev = NULL;
+void mapPutStr(HashMap map, const char* key, size_t len, void* value) {
+    if (!map || !map->strKeys || !key) return;
+    MapProbe probe = _probeStr(map, key, len);
+    _put(map, &probe, value);
+}
 
-    while (current) {
-        if (map->keyEquals(key, current->key, map->keySize)) {
-            if (prev) {
-                prev->next = current->next;
-            } else {
-                map->buckets[index] = current->next;
-            }
-            
-            if (keyFree) keyFree(current->key);
-            xFree(current->key);
+void* mapGetStr(HashMap map, const char* key, size_t len) {
+    if (!map || !map->strKeys || !key) return NULL;
+    MapProbe probe = _probeStr(map, key, len);
+    void* value = NULL;
+    _getKey(map, &probe, &value);
+    return value;
+}
 
-            if (current->value) {
-                if (valFree) valFree(current->value);
-                xFree(current->value);
-            }
-            
-            xFree(current);
-            map->count--;
-            return;
-        }
-        prev = current;
-        current = current->next;
+bool mapContainsStr(HashMap map, const char* key, size_t len) {
+    if (!map || !map->strKeys || !key) return false;
+    MapProbe probe = _probeStr(map, key, len);
+    void* value;
+    return _getKey(map, &probe, &value) != NULL;
+}
+
+void mapRemoveStr(HashMap map, const char* key, size_t len, void (*valFree)(void*)) {
+    if (!map || !map->strKeys || !key) return;
+    MapProbe probe = _probeStr(map, key, len);
+    _remove(map, &probe, NULL, valFree);
+}
+
+size_t mapGetBatch(HashMap map, const void* keys, size_t n, void** outValues) {
+    if (!map || !keys) return 0;
+    return _getBatch(map, keys, n, outValues, NULL);
+}
+
+size_t mapKeyLength(HashMap map, const void* key) {
+    if (!map || !key) return 0;
+    return map->strKeys ? _strKeyOf(key)->len : map->keySize;
+}
+
+void mapReserve(HashMap map, size_t n) {
+    if (!map) return;
+    if (map->engine == MAP_ENGINE_SWISS) {
+        size_t capacity = _swissCapacityFor(n);
+        if (capacity > map->capacity) _swissRebuild(map, capacity);
+        return;
     }
+
+    size_t needed = (n * MAP_LOAD_DEN + MAP_LOAD_NUM - 1) / MAP_LOAD_NUM;
+    if (needed <= map->capacity) return;
+
+    size_t capacity = map->capacity;
+    while (capacity < needed) capacity *= 2;
+    _rehashBegin(map, capacity);
+    mapRehashFinish(map);
 }
 
-void mapClear(HashMap map, void (*keyFree)(void*), void (*valFree)(void*)) {
+void mapRehashFinish(HashMap map) {
     if (!map) return;
-    for (size_t i = 0; i < map->capacity; i++) {
-        MapEntry* current = map->buckets[i];
-        while (current) {
-            MapEntry* next = current->next;
-            
-            if (keyFree) keyFree(current->key);
-            xFree(current->key);
+    while (map->oldBuckets) _rehashStep(map, map->oldCapacity);
+}
 
-            if (current->value) {
-                if (valFree) valFree(current->value);
-                xFree(current->value);
-            }
+MapIterator mapIterator(HashMap map) {
+    MapIterator it = { map, 0 };
+    return it;
+}
 
-            xFree(current);
-            current = next;
+bool mapNext(MapIterator* it, void** key, void** value) {
+    if (!it || !it->map) return false;
+    HashMap map = it->map;
+
+    while (it->index < map->entryCount) {
+        void* k;
+        void* v;
+        if (map->engine == MAP_ENGINE_SWISS) {
+            uint8_t* entry = _entryAt(map, it->index++);
+            if (!_entryHash(entry)) continue;
+            k = _entryKey(map, entry);
+            v = _entryValue(map, entry);
+        } else {
+            MapEntry* entry = map->order[it->index++];
+            if (!entry) continue;
+            k = entry->key;
+            v = entry->value;
         }
-        map->buckets[i] = NULL;
+        if (key) *key = k;
+        if (value) *value = v;
+        return true;
     }
+    return false;
+}
+
+void mapForEach(HashMap map, void (*fn)(void* key, void* value, void* ctx), void* ctx) {
+    if (!map || !fn) return;
+    MapIterator it = mapIterator(map);
+    void* key;
+    void* value;
+    while (mapNext(&it, &key, &value)) fn(key, value, ctx);
+}
+
+static size_t _keyBytes(HashMap map, const void* key) {
+    if (map->strKeys) return sizeof(MapStrKey) + _strKeyOf(key)->len + 1;
+    return map->engine == MAP_ENGINE_CHAINED ? map->keySize : 0;
+}
+
+static void _statsRecord(MapStats* out, size_t probe) {
+    out->probeHistogram[probe < MAP_STATS_HISTOGRAM ? probe - 1 : MAP_STATS_HISTOGRAM - 1]++;
+    if (probe > out->maxProbe) out->maxProbe = probe;
+    if (probe > 1) out->collisions++;
+    out->averageProbe += (double)probe;
+}
+
+static void _statsBuckets(HashMap map, MapEntry** buckets, size_t capacity, MapStats* out) {
+    for (size_t i = 0; i < capacity; i++) {
+        MapEntry* current = buckets[i];
+        if (!current) out->emptyBuckets++;
+        for (size_t depth = 1; current; depth++, current = current->next) {
+            _statsRecord(out, depth);
+            out->bytes += sizeof(MapEntry) + _keyBytes(map, current->key) + map->valueSize;
+        }
+    }
+}
+
+static void _statsSwiss(HashMap map, MapStats* out) {
+    size_t groupMask = map->capacity / SWISS_GROUP - 1;
+    for (size_t slot = 0; slot < map->capacity; slot++) {
+        uint8_t ctrl = map->ctrl[slot];
+        if (ctrl == SWISS_EMPTY) {
+            out->emptyBuckets++;
+            continue;
+        }
+        if (ctrl == SWISS_DELETED) {
+            out->deletedSlots++;
+            continue;
+        }
+
+        uint8_t* entry = _entryAt(map, map->index[slot]);
+        size_t group = (_entryHash(entry) >> 7) & groupMask;
+        size_t probe = 1;
+        for (size_t step = 1; group != slot / SWISS_GROUP && step <= groupMask; step++, probe++)
+            group = (group + step) & groupMask;
+        _statsRecord(out, probe);
+        if (map->strKeys) out->bytes += _keyBytes(map, _entryKey(map, entry));
+    }
+}
+
+bool mapStats(HashMap map, MapStats* out) {
+    if (!map || !out) return false;
+    memset(out, 0, sizeof(*out));
+    out->count = map->count;
+    out->capacity = map->capacity;
+    out->loadFactor = map->capacity ? (double)map->count / (double)map->capacity : 0.0;
+    out->bytes = sizeof(HashMapStruct);
+
+    if (map->engine == MAP_ENGINE_SWISS) {
+        out->bytes += map->capacity * (1 + sizeof(uint32_t)) + map->entryCapacity * map->entrySize;
+        _statsSwiss(map, out);
+    } else {
+        out->bytes += (map->capacity + map->oldCapacity + map->entryCapacity) * sizeof(MapEntry*);
+        _statsBuckets(map, map->buckets, map->capacity, out);
+        if (map->oldBuckets) _statsBuckets(map, map->oldBuckets, map->oldCapacity, out);
+    }
+
+    if (map->count > 0) out->averageProbe /= (double)map->count;
+    out->probes = map->probes;
+    out->lookups = map->lookups;
+    out->maxLookupProbes = map->maxLookupProbes;
+    return true;
+}
+
+void mapResetProbeStats(HashMap map) {
+    if (!map) return;
+    map->probes = 0;
+    map->lookups = 0;
+    map->maxLookupProbes = 0;
+}
+
+void mapClear(HashMap map, void (*keyFree)(void*), void (*valFree)(void*)) {
+    if (!map) return;
+    if (map->engine == MAP_ENGINE_SWISS) {
+        _swissClear(map, keyFree, valFree);
+        map->count = 0;
+        return;
+    }
+
+    _clearBuckets(map, map->buckets, map->capacity, keyFree, valFree);
+    if (map->oldBuckets) {
+        _clearBuckets(map, map->oldBuckets, map->oldCapacity, keyFree, valFree);
+        xFree(map->oldBuckets);
+        map->oldBuckets = NULL;
+        map->oldCapacity = 0;
+        map->rehashIndex = 0;
+    }
+    map->entryCount = 0;
     map->count = 0;
 }
 
@@ -171,6 +969,10 @@ void mapFree(HashMap map, void (*keyFree)(void*), void (*valFree)(void*)) {
     if (!map) return;
     mapClear(map, keyFree, valFree);
     xFree(map->buckets);
+    xFree(map->order);
+    xFree(map->ctrl);
+    xFree(map->index);
+    xFree(map->entries);
     xFree(map);
 }
 
@@ -206,6 +1008,11 @@ bool setContains(Set set, void* key) {
     return mapContains(set->map, key);
 }
 
+size_t setContainsBatch(Set set, const void* keys, size_t n, bool* out) {
+    if (!set || !keys) return 0;
+    return _getBatch(set->map, keys, n, NULL, out);
+}
+
 void setFree(Set set, void (*freeFn)(void*)) {
     if (set) {
         mapFree(set->map, freeFn, NULL);
@@ -221,14 +1028,377 @@ void* setGet(Set set, void* key) {
 Array setToArray(Set set) {
     if (!set) return NULL;
     Array arr = array(set->map->keySize);
-    HashMap map = set->map;
-    
-    for (size_t i = 0; i < map->capacity; i++) {
-        MapEntry* entry = map->buckets[i];
-        while (entry) {
-            arrayAdd(arr, entry->key);
-            entry = entry->next;
+    MapIterator it = mapIterator(set->map);
+    void* key;
+    while (mapNext(&it, &key, NULL))
+        arrayAdd(arr, set->map->strKeys ? (void*)&key : key);
+    return arr;
+}
+
+static bool _setCompatible(Set a, Set b) {
+    return a && b && a->map->keySize == b->map->keySize && a->map->strKeys == b->map->strKeys;
+}
+
+static Set _setEmptyLike(Set like, size_t capacity) {
+    Set set = (Set)xMalloc(sizeof(SetStruct));
+    set->map = like->map->strKeys ? mapCreateStr(0, capacity)
+                                  : mapCreateWithEngine(like->map->keySize, 0, capacity, like->map->engine);
+    return set;
+}
+
+static inline bool _setHas(Set set, void* key) {
+    if (set->map->strKeys) return mapContainsStr(set->map, (const char*)key, _strKeyOf(key)->len);
+    return mapContains(set->map, key);
+}
+
+static inline void _setInsert(Set set, void* key) {
+    if (set->map->strKeys) mapPutStr(set->map, (const char*)key, _strKeyOf(key)->len, NULL);
+    else mapPut(set->map, key, NULL);
+}
+
+static inline void _setErase(Set set, void* key) {
+    if (set->map->strKeys) mapRemoveStr(set->map, (const char*)key, _strKeyOf(key)->len, NULL);
+    else mapRemove(set->map, key, NULL, NULL);
+}
+
+static void _setAddAll(Set dest, Set src) {
+    MapIterator it = mapIterator(src->map);
+    void* key;
+    while (mapNext(&it, &key, NULL)) _setInsert(dest, key);
+}
+
+static size_t _setCountShared(Set a, Set b) {
+    Set small = a->map->count <= b->map->count ? a : b;
+    Set large = small == a ? b : a;
+    size_t shared = 0;
+    MapIterator it = mapIterator(small->map);
+    void* key;
+    while (mapNext(&it, &key, NULL)) shared += _setHas(large, key);
+    return shared;
+}
+
+Set setUnion(Set a, Set b) {
+    if (!_setCompatible(a, b)) return NULL;
+    Set large = a->map->count >= b->map->count ? a : b;
+    Set small = large == a ? b : a;
+    Set result = _setEmptyLike(a, a->map->count + b->map->count);
+    _setAddAll(result, large);
+    _setAddAll(result, small);
+    return result;
+}
+
+Set setIntersect(Set a, Set b) {
+    if (!_setCompatible(a, b)) return NULL;
+    Set small = a->map->count <= b->map->count ? a : b;
+    Set large = small == a ? b : a;
+    Set result = _setEmptyLike(a, small->map->count);
+    MapIterator it = mapIterator(small->map);
+    void* key;
+    while (mapNext(&it, &key, NULL))
+        if (_setHas(large, key)) _setInsert(result, key);
+    return result;
+}
+
+Set setDifference(Set a, Set b) {
+    if (!_setCompatible(a, b)) return NULL;
+    Set result = _setEmptyLike(a, a->map->count);
+    MapIterator it = mapIterator(a->map);
+    void* key;
+    while (mapNext(&it, &key, NULL))
+        if (!_setHas(b, key)) _setInsert(result, key);
+    return result;
+}
+
+void setUnionInPlace(Set a, Set b) {
+    if (!_setCompatible(a, b) || a == b) return;
+    mapReserve(a->map, a->map->count + b->map->count);
+    _setAddAll(a, b);
+}
+
+void setIntersectInPlace(Set a, Set b) {
+    if (!_setCompatible(a, b) || a == b) return;
+    MapIterator it = mapIterator(a->map);
+    void* key;
+    while (mapNext(&it, &key, NULL))
+        if (!_setHas(b, key)) _setErase(a, key);
+}
+
+void setDifferenceInPlace(Set a, Set b) {
+    if (!_setCompatible(a, b)) return;
+    if (a == b) {
+        mapClear(a->map, NULL, NULL);
+        return;
+    }
+
+    MapIterator it = mapIterator(a->map->count <= b->map->count ? a->map : b->map);
+    void* key;
+    if (a->map->count <= b->map->count) {
+        while (mapNext(&it, &key, NULL))
+            if (_setHas(b, key)) _setErase(a, key);
+    } else {
+        while (mapNext(&it, &key, NULL))
+            if (_setHas(a, key)) _setErase(a, key);
+    }
+}
+
+bool setIsSubset(Set a, Set b) {
+    if (!_setCompatible(a, b) || a->map->count > b->map->count) return false;
+    MapIterator it = mapIterator(a->map);
+    void* key;
+    while (mapNext(&it, &key, NULL))
+        if (!_setHas(b, key)) return false;
+    return true;
+}
+
+double setJaccard(Set a, Set b) {
+    if (!_setCompatible(a, b)) return 0.0;
+    size_t total = a->map->count + b->map->count;
+    if (total == 0) return 1.0;
+    size_t shared = _setCountShared(a, b);
+    return (double)shared / (double)(total - shared);
+}
+
+size_t setSize(Set set) {
+    return set ? set->map->count : 0;
+}
+
+#define CONCURRENT_DEFAULT_SHARDS 64
+#define CONCURRENT_SHARD_SHIFT    40
+#define CONCURRENT_SPIN_LIMIT     64
+#define CONCURRENT_STACK_VALUE    256
+
+static inline MapProbe _concurrentProbe(ConcurrentMap cmap, const void* key) {
+    MapProbe probe = { key, cmap->keySize, hashInt(key, cmap->keySize, cmap->seed) | MAP_HASH_LIVE };
+    return probe;
+}
+
+static inline ConcurrentShard* _concurrentShard(ConcurrentMap cmap, const MapProbe* probe) {
+    return &cmap->shards[(probe->hash >> CONCURRENT_SHARD_SHIFT) & (cmap->shardCount - 1)];
+}
+
+static bool _concurrentRead(HashMap map, const MapProbe* probe, void* out) {
+    size_t groupCount = map->capacity / SWISS_GROUP;
+    size_t group = (probe->hash >> 7) & (groupCount - 1);
+    uint8_t h2 = (uint8_t)(probe->hash & 0x7F);
+
+    for (size_t step = 1; step <= groupCount; step++) {
+        const uint8_t* ctrl = map->ctrl + group * SWISS_GROUP;
+        uint32_t match = _groupMatch(ctrl, h2);
+        while (match) {
+            uint32_t index = map->index[group * SWISS_GROUP + (size_t)__builtin_ctz(match)];
+            match &= match - 1;
+            if (index >= map->entryCapacity) continue;
+            uint8_t* entry = _entryAt(map, index);
+            if (_entryHash(entry) != probe->hash || !map->keyEquals(probe->key, entry + SWISS_ENTRY_KEY, map->keySize))
+                continue;
+            if (out && map->valueSize > 0) memcpy(out, entry + map->valueOffset, map->valueSize);
+            return true;
         }
+        if (_groupMatch(ctrl, SWISS_EMPTY)) return false;
+        group = (group + step) & (groupCount - 1);
     }
-    return arr;
-}
\ No newline at end of file
+    return false;
+}
+
+static void _concurrentMapFree(void* map) {
+    mapFree((HashMap)map, NULL, NULL);
+}
+
+static inline void _concurrentPause(unsigned spins) {
+    if (spins >= CONCURRENT_SPIN_LIMIT) {
+        sched_yield();
+        return;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static HashMap _concurrentWritable(ConcurrentShard* shard, const MapProbe* probe) {
+    HashMap map = atomic_load_explicit(&shard->map, memory_order_relaxed);
+    if ((map->growthLeft > 0 && map->entryCount < map->entryCapacity) || _swissFind(map, probe) != SWISS_NONE)
+        return map;
+
+    HashMap grown = mapCreateWithEngine(map->keySize, map->valueSize, map->count * 2, MAP_ENGINE_SWISS);
+    grown->seed = map->seed;
+    for (size_t i = 0; i < map->entryCount; i++) {
+        uint8_t* entry = _entryAt(map, i);
+        uint64_t hash = _entryHash(entry);
+        if (!hash) continue;
+        size_t slot = _swissFindFree(grown, hash);
+        grown->ctrl[slot] = (uint8_t)(hash & 0x7F);
+        grown->index[slot] = (uint32_t)grown->entryCount;
+        memcpy(_entryAt(grown, grown->entryCount++), entry, map->entrySize);
+        grown->growthLeft--;
+    }
+    grown->count = map->count;
+
+    atomic_fetch_add_explicit(&shard->seq, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store(&shard->map, grown);
+    atomic_fetch_add_explicit(&shard->seq, 1, memory_order_release);
+
+    epochRetire(&shard->retired, map, _concurrentMapFree);
+    epochReclaim(&shard->retired);
+    return grown;
+}
+
+static inline void _concurrentWriteBegin(ConcurrentShard* shard) {
+    atomic_fetch_add_explicit(&shard->seq, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void _concurrentWriteEnd(ConcurrentShard* shard) {
+    atomic_fetch_add_explicit(&shard->seq, 1, memory_order_release);
+}
+
+ConcurrentMap concurrentMapCreate(size_t keySize, size_t valueSize, size_t shards) {
+    if (shards == 0) shards = CONCURRENT_DEFAULT_SHARDS;
+    size_t shardCount = 1;
+    while (shardCount < shards && shardCount < ((size_t)1 << 16)) shardCount *= 2;
+
+    ConcurrentMap cmap = (ConcurrentMap)xMalloc(sizeof(ConcurrentMapStruct));
+    cmap->shards = (ConcurrentShard*)xMalloc(shardCount * sizeof(ConcurrentShard));
+    cmap->shardCount = shardCount;
+    cmap->keySize = keySize;
+    cmap->valueSize = valueSize;
+    cmap->seed = hashSeed();
+
+    for (size_t i = 0; i < shardCount; i++) {
+        ConcurrentShard* shard = &cmap->shards[i];
+        HashMap map = mapCreateWithEngine(keySize, valueSize, 0, MAP_ENGINE_SWISS);
+        map->seed = cmap->seed;
+        pthread_mutex_init(&shard->lock, NULL);
+        atomic_init(&shard->seq, 0);
+        atomic_init(&shard->map, map);
+        epochListInit(&shard->retired);
+    }
+    return cmap;
+}
+
+void concurrentMapPut(ConcurrentMap cmap, void* key, void* value) {
+    if (!cmap || !key) return;
+    MapProbe probe = _concurrentProbe(cmap, key);
+    ConcurrentShard* shard = _concurrentShard(cmap, &probe);
+
+    pthread_mutex_lock(&shard->lock);
+    HashMap map = _concurrentWritable(shard, &probe);
+    _concurrentWriteBegin(shard);
+    _swissPut(map, &probe, value);
+    _concurrentWriteEnd(shard);
+    pthread_mutex_unlock(&shard->lock);
+}
+
+bool concurrentMapGet(ConcurrentMap cmap, void* key, void* out) {
+    if (!cmap || !key) return false;
+    MapProbe probe = _concurrentProbe(cmap, key);
+    ConcurrentShard* shard = _concurrentShard(cmap, &probe);
+    bool found;
+
+    epochEnter();
+    for (unsigned spins = 0; ; ) {
+        uint_fast64_t seq = atomic_load_explicit(&shard->seq, memory_order_acquire);
+        if (seq & 1) {
+            _concurrentPause(spins++);
+            continue;
+        }
+        found = _concurrentRead(atomic_load_explicit(&shard->map, memory_order_acquire), &probe, out);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&shard->seq, memory_order_relaxed) == seq) break;
+    }
+    epochExit();
+    return found;
+}
+
+bool concurrentMapContains(ConcurrentMap cmap, void* key) {
+    return concurrentMapGet(cmap, key, NULL);
+}
+
+void concurrentMapRemove(ConcurrentMap cmap, void* key) {
+    if (!cmap || !key) return;
+    MapProbe probe = _concurrentProbe(cmap, key);
+    ConcurrentShard* shard = _concurrentShard(cmap, &probe);
+
+    pthread_mutex_lock(&shard->lock);
+    _concurrentWriteBegin(shard);
+    _swissRemove(atomic_load_explicit(&shard->map, memory_order_relaxed), &probe, NULL, NULL);
+    _concurrentWriteEnd(shard);
+    epochReclaim(&shard->retired);
+    pthread_mutex_unlock(&shard->lock);
+}
+
+bool concurrentMapComputeIfAbsent(ConcurrentMap cmap, void* key, void (*fn)(const void* key, void* value, void* ctx), void* ctx, void* out) {
+    if (!cmap || !key) return false;
+    MapProbe probe = _concurrentProbe(cmap, key);
+    ConcurrentShard* shard = _concurrentShard(cmap, &probe);
+    max_align_t scratch[CONCURRENT_STACK_VALUE / sizeof(max_align_t)];
+    bool computed = false;
+
+    pthread_mutex_lock(&shard->lock);
+    HashMap map = _concurrentWritable(shard, &probe);
+    size_t slot = _swissFind(map, &probe);
+    if (slot == SWISS_NONE) {
+        void* value = map->valueSize <= sizeof(scratch) ? (void*)scratch : xMalloc(map->valueSize);
+        memset(value, 0, map->valueSize);
+        if (fn) fn(key, value, ctx);
+        _concurrentWriteBegin(shard);
+        _swissPut(map, &probe, value);
+        _concurrentWriteEnd(shard);
+        if (out && map->valueSize > 0) memcpy(out, value, map->valueSize);
+        if (value != (void*)scratch) xFree(value);
+        computed = true;
+    } else if (out && map->valueSize > 0) {
+        memcpy(out, _entryValue(map, _entryAt(map, map->index[slot])), map->valueSize);
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return computed;
+}
+
+bool concurrentMapUpdate(ConcurrentMap cmap, void* key, void (*fn)(const void* key, void* value, void* ctx), void* ctx) {
+    if (!cmap || !key || !fn) return false;
+    MapProbe probe = _concurrentProbe(cmap, key);
+    ConcurrentShard* shard = _concurrentShard(cmap, &probe);
+    max_align_t scratch[CONCURRENT_STACK_VALUE / sizeof(max_align_t)];
+
+    pthread_mutex_lock(&shard->lock);
+    HashMap map = atomic_load_explicit(&shard->map, memory_order_relaxed);
+    size_t slot = _swissFind(map, &probe);
+    if (slot != SWISS_NONE) {
+        void* stored = _entryValue(map, _entryAt(map, map->index[slot]));
+        void* value = map->valueSize <= sizeof(scratch) ? (void*)scratch : xMalloc(map->valueSize);
+        if (map->valueSize > 0) memcpy(value, stored, map->valueSize);
+        fn(key, value, ctx);
+        _concurrentWriteBegin(shard);
+        if (map->valueSize > 0) memcpy(stored, value, map->valueSize);
+        _concurrentWriteEnd(shard);
+        if (value != (void*)scratch) xFree(value);
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return slot != SWISS_NONE;
+}
+
+size_t concurrentMapSize(ConcurrentMap cmap) {
+    if (!cmap) return 0;
+    size_t count = 0;
+    for (size_t i = 0; i < cmap->shardCount; i++) {
+        ConcurrentShard* shard = &cmap->shards[i];
+        pthread_mutex_lock(&shard->lock);
+        count += atomic_load_explicit(&shard->map, memory_order_relaxed)->count;
+        pthread_mutex_unlock(&shard->lock);
+    }
+    return count;
+}
+
+void concurrentMapFree(ConcurrentMap cmap) {
+    if (!cmap) return;
+    for (size_t i = 0; i < cmap->shardCount; i++) {
+        ConcurrentShard* shard = &cmap->shards[i];
+        epochDrain(&shard->retired);
+        mapFree(atomic_load(&shard->map), NULL, NULL);
+        pthread_mutex_destroy(&shard->lock);
+    }
+    xFree(cmap->shards);
+    xFree(cmap);
+}
@@ -0,0 +1,420 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/perfectmaps.h"
+#include "../include/maps.h"
+#include "../include/pointers.h"
+
+#define PERFECT_BUCKET_SIZE  4
+#define PERFECT_MAX_DISP     (1u << 20)
+#define PERFECT_MAX_ATTEMPTS 16
+#define PERFECT_NONE         UINT32_MAX
+#define PERFECT_ALIGN        _Alignof(max_align_t)
+
+static const char _perfectMagic[8] = { 'C', 'D', 'S', 'P', 'H', 'A', 'S', 'H' };
+
+typedef struct {
+    const uint8_t* data;
+    size_t len;
+    uint64_t hash;
+    uint32_t bucket;
+    uint32_t index;
+} PerfectKey;
+
+typedef struct {
+    uint32_t bucket;
+    uint32_t start;
+    uint32_t size;
+} PerfectBucket;
+
+static inline uint32_t _bucketOf(uint64_t hash, uint32_t bucketCount) {
+    return (uint32_t)(((hash & 0xFFFFFFFFull) * bucketCount) >> 32);
+}
+
+static inline uint32_t _slotOf(uint64_t hash, uint32_t disp, uint32_t slotCount) {
+    uint64_t z = hash ^ ((uint64_t)disp * 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z ^= z >> 31;
+    return (uint32_t)(((z >> 32) * slotCount) >> 32);
+}
+
+static int _compareBuckets(const void* a, const void* b) {
+    const PerfectBucket* x = (const PerfectBucket*)a;
+    const PerfectBucket* y = (const PerfectBucket*)b;
+    if (x->size != y->size) return x->size < y->size ? 1 : -1;
+    return x->bucket < y->bucket ? -1 : x->bucket > y->bucket;
+}
+
+static int _compareKeys(const void* a, const void* b) {
+    const PerfectKey* x = (const PerfectKey*)a;
+    const PerfectKey* y = (const PerfectKey*)b;
+    return x->bucket < y->bucket ? -1 : x->bucket > y->bucket;
+}
+
+static inline size_t _alignUp(size_t n) {
+    return (n + PERFECT_ALIGN - 1) & ~(PERFECT_ALIGN - 1);
+}
+
+static inline bool _reserve(size_t* size, size_t count, size_t unit) {
+    if (unit && count > (SIZE_MAX - PERFECT_ALIGN - *size) / unit) return false;
+    *size += count * unit;
+    return true;
+}
+
+static size_t _layout(PerfectMap map, size_t keyBytes, size_t* offsets) {
+    size_t size = 0;
+    offsets[0] = size;
+    bool ok = _reserve(&size, map->bucketCount, sizeof(uint32_t));
+    offsets[1] = size;
+    if (!map->keySize) ok = ok && _reserve(&size, (size_t)map->slotCount + 1, sizeof(uint32_t));
+    offsets[2] = size;
+    ok = ok && _reserve(&size, map->slotCount, 1);
+    size = _alignUp(size);
+    offsets[3] = size;
+    ok = ok && _reserve(&size, keyBytes, 1);
+    size = _alignUp(size);
+    offsets[4] = size;
+    ok = ok && _reserve(&size, map->slotCount, map->valueSize);
+    return ok ? size : SIZE_MAX;
+}
+
+static bool _attach(PerfectMap map, size_t keyBytes) {
+    size_t offsets[5];
+    size_t size = _layout(map, keyBytes, offsets);
+    uint8_t* memory = size == SIZE_MAX ? NULL : (uint8_t*)xCalloc(size ? size : 1, 1);
+    map->memory = memory;
+    if (!memory) return false;
+    map->disp = (const uint32_t*)(memory + offsets[0]);
+    map->offsets = map->keySize ? NULL : (const uint32_t*)(memory + offsets[1]);
+    map->used = memory + offsets[2];
+    map->keys = memory + offsets[3];
+    map->values = map->valueSize ? memory + offsets[4] : NULL;
+    return true;
+}
+
+static bool _place(PerfectKey* keys, uint32_t n, uint32_t bucketCount, uint32_t slotCount, uint32_t* disp, uint32_t* slotKey) {
+    PerfectBucket* buckets = (PerfectBucket*)xCalloc(bucketCount, sizeof(PerfectBucket));
+    uint32_t* slots = (uint32_t*)xMalloc(n * sizeof(uint32_t));
+    bool ok = true;
+
+    qsort(keys, n, sizeof(PerfectKey), _compareKeys);
+    for (uint32_t b = 0; b < bucketCount; b++) buckets[b].bucket = b;
+    for (uint32_t i = 0; i < n; i++) {
+        PerfectBucket* bucket = &buckets[keys[i].bucket];
+        if (bucket->size == 0) bucket->start = i;
+        bucket->size++;
+    }
+    qsort(buckets, bucketCount, sizeof(PerfectBucket), _compareBuckets);
+
+    for (uint32_t s = 0; s < slotCount; s++) slotKey[s] = PERFECT_NONE;
+    memset(disp, 0, bucketCount * sizeof(uint32_t));
+
+    for (uint32_t b = 0; b < bucketCount && ok; b++) {
+        PerfectBucket* bucket = &buckets[b];
+        if (bucket->size == 0) break;
+
+        uint32_t d = 0;
+        for (; d < PERFECT_MAX_DISP; d++) {
+            uint32_t placed = 0;
+            for (; placed < bucket->size; placed++) {
+                uint32_t slot = _slotOf(keys[bucket->start + placed].hash, d, slotCount);
+                if (slotKey[slot] != PERFECT_NONE) break;
+                bool clash = false;
+                for (uint32_t j = 0; j < placed && !clash; j++) clash = slots[j] == slot;
+                if (clash) break;
+                slots[placed] = slot;
+            }
+            if (placed == bucket->size) break;
+        }
+        if (d == PERFECT_MAX_DISP) {
+            ok = false;
+            break;
+        }
+
+        disp[bucket->bucket] = d;
+        for (uint32_t j = 0; j < bucket->size; j++) slotKey[slots[j]] = bucket->start + j;
+    }
+
+    xFree(slots);
+    xFree(buckets);
+    return ok;
+}
+
+static PerfectMap _build(Array keys, Array values, bool strKeys) {
+    if (!keys || keys->len == 0 || keys->len >= PERFECT_NONE) return NULL;
+    if (values && (values->len != keys->len || values->esize >= PERFECT_NONE)) return NULL;
+    if (!strKeys && keys->esize >= PERFECT_NONE) return NULL;
+
+    uint32_t n = (uint32_t)keys->len;
+    PerfectKey* items = (PerfectKey*)xMalloc(n * sizeof(PerfectKey));
+    HashMap seen = strKeys ? mapCreateStr(0, n) : mapCreate(keys->esize, 0, n);
+    size_t keyBytes = 0;
+    bool unique = true;
+
+    for (uint32_t i = 0; i < n && unique; i++) {
+        uint8_t* element = (uint8_t*)keys->data + (size_t)i * keys->esize;
+        items[i].data = strKeys ? *(const uint8_t**)element : element;
+        items[i].len = strKeys ? strlen((const char*)items[i].data) : keys->esize;
+        items[i].index = i;
+        keyBytes += items[i].len;
+        if (strKeys) {
+            unique = !mapContainsStr(seen, (const char*)items[i].data, items[i].len);
+            mapPutStr(seen, (const char*)items[i].data, items[i].len, NULL);
+        } else {
+            unique = !mapContains(seen, element);
+            mapPut(seen, element, NULL);
+        }
+    }
+    mapFree(seen, NULL, NULL);
+    if (!unique || keyBytes >= PERFECT_NONE) {
+        xFree(items);
+        return NULL;
+    }
+
+    PerfectMap map = (PerfectMap)xMalloc(sizeof(PerfectMapStruct));
+    map->count = n;
+    map->bucketCount = n / PERFECT_BUCKET_SIZE + 1;
+    map->slotCount = n + n / 8 + 1;
+    map->keySize = strKeys ? 0 : (uint32_t)keys->esize;
+    map->valueSize = values ? (uint32_t)values->esize : 0;
+    if (!strKeys) keyBytes = (size_t)map->slotCount * map->keySize;
+    if (!_attach(map, keyBytes)) {
+        xFree(map);
+        xFree(items);
+        return NULL;
+    }
+
+    uint32_t* disp = (uint32_t*)map->disp;
+    uint32_t* slotKey = (uint32_t*)xMalloc(map->slotCount * sizeof(uint32_t));
+    bool placed = false;
+    for (int attempt = 0; attempt < PERFECT_MAX_ATTEMPTS && !placed; attempt++) {
+        map->seed = hashSeed();
+        for (uint32_t i = 0; i < n; i++) {
+            items[i].hash = hashBytes(items[i].data, items[i].len, map->seed);
+            items[i].bucket = _bucketOf(items[i].hash, map->bucketCount);
+        }
+        placed = _place(items, n, map->bucketCount, map->slotCount, disp, slotKey);
+    }
+
+    if (placed) {
+        uint32_t* offsets = (uint32_t*)map->offsets;
+        uint8_t* used = (uint8_t*)map->used;
+        uint8_t* keyData = (uint8_t*)map->keys;
+        uint8_t* valueData = (uint8_t*)map->values;
+        uint32_t cursor = 0;
+
+        for (uint32_t s = 0; s < map->slotCount; s++) {
+            if (offsets) offsets[s] = cursor;
+            if (slotKey[s] == PERFECT_NONE) continue;
+            PerfectKey* item = &items[slotKey[s]];
+            used[s] = 1;
+            if (offsets) {
+                memcpy(keyData + cursor, item->data, item->len);
+                cursor += (uint32_t)item->len;
+            } else {
+                memcpy(keyData + (size_t)s * map->keySize, item->data, map->keySize);
+            }
+            if (valueData)
+                memcpy(valueData + (size_t)s * map->valueSize,
+                       (uint8_t*)values->data + (size_t)item->index * values->esize, map->valueSize);
+        }
+        if (offsets) offsets[map->slotCount] = cursor;
+    }
+
+    xFree(slotKey);
+    xFree(items);
+    if (!placed) {
+        perfectMapFree(map);
+        return NULL;
+    }
+    return map;
+}
+
+static uint32_t _find(PerfectMap map, const void* key, size_t len) {
+    uint64_t hash = hashBytes(key, len, map->seed);
+    uint32_t slot = _slotOf(hash, map->disp[_bucketOf(hash, map->bucketCount)], map->slotCount);
+    if (!map->used[slot]) return PERFECT_NONE;
+
+    if (map->offsets) {
+        uint32_t start = map->offsets[slot];
+        if (map->offsets[slot + 1] - start != len || memcmp(map->keys + start, key, len) != 0)
+            return PERFECT_NONE;
+    } else if (memcmp(map->keys + (size_t)slot * map->keySize, key, map->keySize) != 0) {
+        return PERFECT_NONE;
+    }
+    return slot;
+}
+
+static void* _valueAt(PerfectMap map, uint32_t slot) {
+    if (slot == PERFECT_NONE) return NULL;
+    if (map->values) return (void*)(map->values + (size_t)slot * map->valueSize);
+    return map->offsets ? (void*)(map->keys + map->offsets[slot])
+                        : (void*)(map->keys + (size_t)slot * map->keySize);
+}
+
+PerfectMap perfectMapBuild(Array keys, Array values) {
+    return _build(keys, values, false);
+}
+
+PerfectMap perfectMapBuildStr(Array keys, Array values) {
+    if (keys && keys->esize != sizeof(char*)) return NULL;
+    return _build(keys, values, true);
+}
+
+void* perfectMapGet(PerfectMap map, const void* key) {
+    if (!map || !key || !map->keySize) return NULL;
+    return _valueAt(map, _find(map, key, map->keySize));
+}
+
+void* perfectMapGetStr(PerfectMap map, const char* key, size_t len) {
+    if (!map || !key || map->keySize) return NULL;
+    return _valueAt(map, _find(map, key, len));
+}
+
+bool perfectMapContains(PerfectMap map, const void* key) {
+    if (!map || !key || !map->keySize) return false;
+    return _find(map, key, map->keySize) != PERFECT_NONE;
+}
+
+bool perfectMapContainsStr(PerfectMap map, const char* key, size_t len) {
+    if (!map || !key || map->keySize) return false;
+    return _find(map, key, len) != PERFECT_NONE;
+}
+
+static bool _writePad(FILE* fp, size_t n) {
+    static const uint8_t zeros[PERFECT_ALIGN];
+    return fwrite(zeros, 1, n, fp) == n;
+}
+
+static size_t _keyBytes(PerfectMap map) {
+    return map->offsets ? map->offsets[map->slotCount] : (size_t)map->slotCount * map->keySize;
+}
+
+bool perfectMapSave(PerfectMap map, const char* path) {
+    if (!map || !path) return false;
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return false;
+
+    size_t offsets[5];
+    size_t keyBytes = _keyBytes(map);
+    size_t size = _layout(map, keyBytes, offsets);
+    uint64_t fields[7] = { map->seed, map->count, map->slotCount, map->bucketCount, map->keySize, map->valueSize, keyBytes };
+
+    bool ok = fwrite(_perfectMagic, 1, 8, fp) == 8 && fwrite(fields, sizeof(uint64_t), 7, fp) == 7;
+    ok = ok && fwrite(map->disp, sizeof(uint32_t), map->bucketCount, fp) == map->bucketCount;
+    if (map->offsets) ok = ok && fwrite(map->offsets, sizeof(uint32_t), map->slotCount + 1, fp) == map->slotCount + 1;
+    ok = ok && fwrite(map->used, 1, map->slotCount, fp) == map->slotCount;
+    ok = ok && _writePad(fp, offsets[3] - offsets[2] - map->slotCount);
+    ok = ok && fwrite(map->keys, 1, keyBytes, fp) == keyBytes;
+    ok = ok && _writePad(fp, offsets[4] - offsets[3] - keyBytes);
+    if (map->values) ok = ok && fwrite(map->values, 1, size - offsets[4], fp) == size - offsets[4];
+    fclose(fp);
+    return ok;
+}
+
+PerfectMap perfectMapLoad(const char* path) {
+    if (!path) return NULL;
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return NULL;
+
+    char magic[8];
+    uint64_t fields[7];
+    if (fread(magic, 1, 8, fp) != 8 || memcmp(magic, _perfectMagic, 8) != 0 ||
+        fread(fields, sizeof(uint64_t), 7, fp) != 7 || fields[2] == 0 || fields[3] == 0 ||
+        fields[2] >= PERFECT_NONE || fields[3] >= PERFECT_NONE || fields[6] >= PERFECT_NONE ||
+        fields[1] > fields[2] || fields[4] > UINT32_MAX || fields[5] > UINT32_MAX) {
+        fclose(fp);
+        return NULL;
+    }
+
+    PerfectMap map = (PerfectMap)xMalloc(sizeof(PerfectMapStruct));
+    map->seed = fields[0];
+    map->count = (uint32_t)fields[1];
+    map->slotCount = (uint32_t)fields[2];
+    map->bucketCount = (uint32_t)fields[3];
+    map->keySize = (uint32_t)fields[4];
+    map->valueSize = (uint32_t)fields[5];
+    map->memory = NULL;
+
+    size_t offsets[5];
+    size_t size = _layout(map, (size_t)fields[6], offsets);
+    long start = ftell(fp);
+    bool ok = size != SIZE_MAX && start >= 0 && fseek(fp, 0, SEEK_END) == 0;
+    long end = ok ? ftell(fp) : -1;
+    ok = ok && end >= start && (uint64_t)(end - start) == size && fseek(fp, start, SEEK_SET) == 0;
+    ok = ok && _attach(map, (size_t)fields[6]) && fread(map->memory, 1, size, fp) == size;
+    fclose(fp);
+
+    if (ok && map->offsets && map->offsets[map->slotCount] != fields[6]) ok = false;
+    if (ok && !map->offsets && fields[6] != (uint64_t)map->slotCount * map->keySize) ok = false;
+    if (ok) {
+        for (uint32_t b = 0; b < map->bucketCount && ok; b++) ok = map->disp[b] < PERFECT_MAX_DISP;
+        for (uint32_t s = 0; s < map->slotCount && ok && map->offsets; s++)
+            ok = map->offsets[s] <= map->offsets[s + 1];
+    }
+    if (!ok) {
+        xFree(map->memory);
+        xFree(map);
+        return NULL;
+    }
+    return map;
+}
+
+static void _dumpBytes(FILE* fp, const char* name, const char* suffix, const uint8_t* data, size_t len, bool aligned) {
+    fprintf(fp, "static %sconst uint8_t %s_%s[%zu] = {", aligned ? "_Alignas(max_align_t) " : "", name, suffix, len);
+    for (size_t i = 0; i < len; i++)
+        fprintf(fp, "%s0x%02x,", i % 16 ? " " : "\n    ", data[i]);
+    fprintf(fp, "\n};\n\n");
+}
+
+static void _dumpWords(FILE* fp, const char* name, const char* suffix, const uint32_t* data, size_t len) {
+    fprintf(fp, "static const uint32_t %s_%s[%zu] = {", name, suffix, len);
+    for (size_t i = 0; i < len; i++)
+        fprintf(fp, "%s%uu,", i % 8 ? " " : "\n    ", data[i]);
+    fprintf(fp, "\n};\n\n");
+}
+
+bool perfectMapDumpHeader(PerfectMap map, const char* path, const char* name) {
+    if (!map || !path || !name) return false;
+    FILE* fp = fopen(path, "w");
+    if (!fp) return false;
+
+    size_t keyBytes = _keyBytes(map);
+    fprintf(fp, "#ifndef %s_PERFECT_H\n#define %s_PERFECT_H\n\n", name, name);
+    fprintf(fp, "#include <stddef.h>\n#include \"perfectmaps.h\"\n\n");
+    _dumpWords(fp, name, "disp", map->disp, map->bucketCount);
+    if (map->offsets) _dumpWords(fp, name, "offsets", map->offsets, (size_t)map->slotCount + 1);
+    _dumpBytes(fp, name, "used", map->used, map->slotCount, false);
+    if (keyBytes) _dumpBytes(fp, name, "keys", map->keys, keyBytes, true);
+    if (map->values) _dumpBytes(fp, name, "values", map->values, (size_t)map->slotCount * map->valueSize, true);
+
+    fprintf(fp, "static PerfectMapStruct %s = {\n", name);
+    fprintf(fp, "    .seed = 0x%016llxull,\n", (unsigned long long)map->seed);
+    fprintf(fp, "    .count = %uu,\n", map->count);
+    fprintf(fp, "    .slotCount = %uu,\n", map->slotCount);
+    fprintf(fp, "    .bucketCount = %uu,\n", map->bucketCount);
+    fprintf(fp, "    .keySize = %uu,\n", map->keySize);
+    fprintf(fp, "    .valueSize = %uu,\n", map->valueSize);
+    fprintf(fp, "    .disp = %s_disp,\n", name);
+    if (map->offsets) fprintf(fp, "    .offsets = %s_offsets,\n", name);
+    else fprintf(fp, "    .offsets = NULL,\n");
+    fprintf(fp, "    .used = %s_used,\n", name);
+    if (keyBytes) fprintf(fp, "    .keys = %s_keys,\n", name);
+    else fprintf(fp, "    .keys = %s_used,\n", name);
+    if (map->values) fprintf(fp, "    .values = %s_values,\n", name);
+    else fprintf(fp, "    .values = NULL,\n");
+    fprintf(fp, "    .memory = NULL\n};\n\n#endif\n");
+
+    bool ok = !ferror(fp);
+    fclose(fp);
+    return ok;
+}
+
+void perfectMapFree(PerfectMap map) {
+    if (!map) return;
+    if (map->memory) {
+        xFree(map->memory);
+        xFree(map);
+    }
+}
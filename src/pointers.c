@@ -63,7 +63,7 @@ typedef struct FreeNode {
 } FreeNode;
 
 
-typedef struct Slab {
+typedef struct __attribute__((aligned(16))) Slab {
     struct Slab* next;
     size_t       freeCount;
     size_t       totalCount;
@@ -73,12 +73,15 @@ typedef struct Slab {
 } Slab;
 
 
-typedef struct LargeBlock {
+typedef struct __attribute__((aligned(16))) LargeBlock {
     size_t             size;
     int                numaNode;
     struct LargeBlock* next;
 } LargeBlock;
 
+_Static_assert(sizeof(Slab) % ALIGNMENT == 0 && sizeof(LargeBlock) % ALIGNMENT == 0,
+               "Slab and LargeBlock must keep the blocks after them ALIGNMENT-aligned");
+
 
 typedef struct {
     atomic_size_t allocs;
@@ -273,27 +276,6 @@ static inline Arena* getArena(void) {
 }
 
 
-static void tryReclaimSlabs(Arena* arena, int classIdx) {
-    Slab** pp   = &arena->slabs[classIdx];
-    Slab*  cur  = *pp;
-    while (cur) {
-        Slab* next = cur->next;
-        if (cur->freeCount == cur->totalCount) {
-            *pp = next;
-            size_t objSize  = getClassSize(classIdx) + sizeof(BlockHeader);
-            size_t slabSize = pageAlign(sizeof(Slab) + objSize * BLOCK_REFILL_COUNT);
-            munmap(cur, slabSize);
-            atomic_fetch_add_explicit(&gStats.munmapCalls,          1, memory_order_relaxed);
-            atomic_fetch_add_explicit(&gStats.perClass[classIdx].slabsReclaimed,
-                                      1, memory_order_relaxed);
-        } else {
-            pp = &cur->next;
-        }
-        cur = next;
-    }
-}
-
-
 static void newSlab(Arena* arena, int classIdx) {
     size_t objSize  = getClassSize(classIdx) + sizeof(BlockHeader);
     size_t slabSize = pageAlign(sizeof(Slab) + objSize * BLOCK_REFILL_COUNT);
@@ -443,7 +425,6 @@ static void _xFreeImmediate(void* ptr) {
                     }
                     moved++;
                 }
-                tryReclaimSlabs(arena, classIdx);
                 pthread_mutex_unlock(&arena->lock);
             }
         }
@@ -0,0 +1,226 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/segtrees.h"
+#include "../include/pointers.h"
+
+static double _sum(double a, double b) {
+    return a + b;
+}
+
+static double _min(double a, double b) {
+    return a < b ? a : b;
+}
+
+static double _max(double a, double b) {
+    return a > b ? a : b;
+}
+
+static double _applySum(double aggregate, double delta, size_t len) {
+    return aggregate + delta * (double)len;
+}
+
+static double _applyShift(double aggregate, double delta, size_t len) {
+    (void)len;
+    return aggregate + delta;
+}
+
+const SegmentOp SEGMENT_SUM = { _sum, 0.0, _applySum };
+const SegmentOp SEGMENT_MIN = { _min, INFINITY, _applyShift };
+const SegmentOp SEGMENT_MAX = { _max, -INFINITY, _applyShift };
+
+FenwickTree fenwickCreate(size_t n) {
+    FenwickTree f = (FenwickTree)xMalloc(sizeof(FenwickTreeStruct));
+    f->n = n;
+    f->tree = (double*)xCalloc(n + 1, sizeof(double));
+    return f;
+}
+
+static void _fenwickBuild(FenwickTree f) {
+    for (size_t i = 1; i <= f->n; i++) {
+        size_t parent = i + (i & (~i + 1));
+        if (parent <= f->n) f->tree[parent] += f->tree[i];
+    }
+}
+
+FenwickTree fenwickFromArray(Array arr) {
+    if (!arr || arr->esize != sizeof(double)) return NULL;
+    FenwickTree f = fenwickCreate(arr->len);
+    memcpy(f->tree + 1, arr->data, arr->len * sizeof(double));
+    _fenwickBuild(f);
+    return f;
+}
+
+FenwickTree fenwickFromIntArray(Array arr) {
+    if (!arr || arr->esize != sizeof(int)) return NULL;
+    FenwickTree f = fenwickCreate(arr->len);
+    const int* src = (const int*)arr->data;
+    for (size_t i = 0; i < arr->len; i++) f->tree[i + 1] = src[i];
+    _fenwickBuild(f);
+    return f;
+}
+
+void fenwickAdd(FenwickTree f, size_t index, double delta) {
+    if (!f || index >= f->n) return;
+    for (size_t i = index + 1; i <= f->n; i += i & (~i + 1)) f->tree[i] += delta;
+}
+
+double fenwickPrefixSum(FenwickTree f, size_t end) {
+    if (!f) return 0.0;
+    if (end > f->n) end = f->n;
+    double sum = 0.0;
+    for (size_t i = end; i > 0; i &= i - 1) sum += f->tree[i];
+    return sum;
+}
+
+double fenwickRangeSum(FenwickTree f, size_t start, size_t end) {
+    if (!f || start >= end) return 0.0;
+    return fenwickPrefixSum(f, end) - fenwickPrefixSum(f, start);
+}
+
+double fenwickGet(FenwickTree f, size_t index) {
+    return fenwickRangeSum(f, index, index + 1);
+}
+
+void fenwickSet(FenwickTree f, size_t index, double value) {
+    if (!f || index >= f->n) return;
+    fenwickAdd(f, index, value - fenwickGet(f, index));
+}
+
+size_t fenwickSize(FenwickTree f) {
+    return f ? f->n : 0;
+}
+
+void fenwickFree(FenwickTree f) {
+    if (!f) return;
+    xFree(f->tree);
+    xFree(f);
+}
+
+static void _segmentPull(SegmentTree st, size_t p, size_t len) {
+    st->tree[p] = st->op.combine(st->tree[p << 1], st->tree[p << 1 | 1]);
+    if (st->lazy[p] != 0.0) st->tree[p] = st->op.apply(st->tree[p], st->lazy[p], len);
+}
+
+static void _segmentApply(SegmentTree st, size_t p, double delta, size_t len) {
+    st->tree[p] = st->op.apply(st->tree[p], delta, len);
+    if (p < st->n) st->lazy[p] += delta;
+}
+
+static void _segmentRebuild(SegmentTree st, size_t p) {
+    size_t len = 2;
+    for (p += st->n; p > 1; len <<= 1) {
+        p >>= 1;
+        _segmentPull(st, p, len);
+    }
+}
+
+static void _segmentPush(SegmentTree st, size_t p) {
+    if (!st->op.apply) return;
+    p += st->n;
+    size_t len = (size_t)1 << (st->height - 1);
+    for (int s = st->height; s > 0; s--, len >>= 1) {
+        size_t i = p >> s;
+        if (i == 0 || st->lazy[i] == 0.0) continue;
+        _segmentApply(st, i << 1, st->lazy[i], len);
+        _segmentApply(st, i << 1 | 1, st->lazy[i], len);
+        st->lazy[i] = 0.0;
+    }
+}
+
+static void _segmentBuild(SegmentTree st) {
+    for (size_t p = st->n; p-- > 1;)
+        st->tree[p] = st->op.combine(st->tree[p << 1], st->tree[p << 1 | 1]);
+}
+
+SegmentTree segmentTreeCreate(size_t n, SegmentOp op) {
+    if (!op.combine) return NULL;
+    SegmentTree st = (SegmentTree)xMalloc(sizeof(SegmentTreeStruct));
+    st->n = n;
+    st->op = op;
+    st->height = 0;
+    while (((size_t)1 << st->height) < n) st->height++;
+    st->height++;
+    st->tree = (double*)xMalloc((2 * n + 1) * sizeof(double));
+    st->lazy = (double*)xCalloc(n + 1, sizeof(double));
+    for (size_t i = 0; i < 2 * n + 1; i++) st->tree[i] = op.identity;
+    return st;
+}
+
+SegmentTree segmentTreeFromArray(Array arr, SegmentOp op) {
+    if (!arr || arr->esize != sizeof(double)) return NULL;
+    SegmentTree st = segmentTreeCreate(arr->len, op);
+    if (!st) return NULL;
+    memcpy(st->tree + st->n, arr->data, arr->len * sizeof(double));
+    _segmentBuild(st);
+    return st;
+}
+
+SegmentTree segmentTreeFromIntArray(Array arr, SegmentOp op) {
+    if (!arr || arr->esize != sizeof(int)) return NULL;
+    SegmentTree st = segmentTreeCreate(arr->len, op);
+    if (!st) return NULL;
+    const int* src = (const int*)arr->data;
+    for (size_t i = 0; i < arr->len; i++) st->tree[st->n + i] = src[i];
+    _segmentBuild(st);
+    return st;
+}
+
+void segmentTreeSet(SegmentTree st, size_t index, double value) {
+    if (!st || index >= st->n) return;
+    _segmentPush(st, index);
+    st->tree[index + st->n] = value;
+    _segmentRebuild(st, index);
+}
+
+double segmentTreeQuery(SegmentTree st, size_t start, size_t end) {
+    if (!st) return 0.0;
+    if (end > st->n) end = st->n;
+    if (start >= end) return st->op.identity;
+
+    _segmentPush(st, start);
+    _segmentPush(st, end - 1);
+    double left = st->op.identity;
+    double right = st->op.identity;
+    for (size_t l = start + st->n, r = end + st->n; l < r; l >>= 1, r >>= 1) {
+        if (l & 1) left = st->op.combine(left, st->tree[l++]);
+        if (r & 1) right = st->op.combine(st->tree[--r], right);
+    }
+    return st->op.combine(left, right);
+}
+
+double segmentTreeGet(SegmentTree st, size_t index) {
+    return segmentTreeQuery(st, index, index + 1);
+}
+
+void segmentTreeRangeAdd(SegmentTree st, size_t start, size_t end, double delta) {
+    if (!st || delta == 0.0) return;
+    if (end > st->n) end = st->n;
+    if (start >= end) return;
+
+    if (!st->op.apply) {
+        for (size_t i = start; i < end; i++) segmentTreeSet(st, i, segmentTreeGet(st, i) + delta);
+        return;
+    }
+
+    _segmentPush(st, start);
+    _segmentPush(st, end - 1);
+    size_t len = 1;
+    for (size_t l = start + st->n, r = end + st->n; l < r; l >>= 1, r >>= 1, len <<= 1) {
+        if (l & 1) _segmentApply(st, l++, delta, len);
+        if (r & 1) _segmentApply(st, --r, delta, len);
+    }
+    _segmentRebuild(st, start);
+    _segmentRebuild(st, end - 1);
+}
+
+size_t segmentTreeSize(SegmentTree st) {
+    return st ? st->n : 0;
+}
+
+void segmentTreeFree(SegmentTree st) {
+    if (!st) return;
+    xFree(st->tree);
+    xFree(st->lazy);
+    xFree(st);
+}
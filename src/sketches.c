@@ -0,0 +1,500 @@
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../include/sketches.h"
+#include "../include/pointers.h"
+
+#define SKETCH_SEED       0x2d358dccaa6c78a5ull
+#define HLL_MIN_PRECISION 4
+#define HLL_MAX_PRECISION 18
+#define HLL_SPARSE_BUFFER 64
+
+static const char _hllMagic[4] = { 'H', 'L', 'L', '1' };
+static const char _cmsMagic[4] = { 'C', 'M', 'S', '1' };
+static const char _topKMagic[4] = { 'T', 'O', 'P', 'K' };
+
+typedef struct {
+    const uint8_t* data;
+    size_t left;
+} ByteReader;
+
+static void _bytesPut(Array out, const void* data, size_t n) {
+    while (out->len + n > out->capacity) arrayGrow(out);
+    memcpy((uint8_t*)out->data + out->len, data, n);
+    out->len += n;
+}
+
+static void _bytesPutU64(Array out, uint64_t v) {
+    _bytesPut(out, &v, sizeof(v));
+}
+
+static bool _bytesGet(ByteReader* in, void* data, size_t n) {
+    if (in->left < n) return false;
+    memcpy(data, in->data, n);
+    in->data += n;
+    in->left -= n;
+    return true;
+}
+
+static bool _bytesGetU64(ByteReader* in, uint64_t* v) {
+    return _bytesGet(in, v, sizeof(*v));
+}
+
+static bool _bytesMagic(ByteReader* in, const char magic[4]) {
+    char buf[4];
+    return _bytesGet(in, buf, 4) && memcmp(buf, magic, 4) == 0;
+}
+
+static ByteReader _bytesReader(Array bytes) {
+    ByteReader in = { (const uint8_t*)bytes->data, bytes->len * bytes->esize };
+    return in;
+}
+
+static inline size_t _hllRegisters(HyperLogLog hll) {
+    return (size_t)1 << hll->precision;
+}
+
+static inline uint32_t _hllEntry(HyperLogLog hll, uint64_t hash) {
+    uint32_t index = (uint32_t)(hash >> (64 - hll->precision));
+    uint64_t rest = (hash << hll->precision) | ((uint64_t)1 << (hll->precision - 1));
+    return (index << 8) | (uint32_t)(__builtin_clzll(rest) + 1);
+}
+
+static int _compareEntries(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static void _hllCompact(HyperLogLog hll) {
+    if (hll->sortedCount == hll->entryCount) return;
+    qsort(hll->entries, hll->entryCount, sizeof(uint32_t), _compareEntries);
+    size_t out = 0;
+    for (size_t i = 0; i < hll->entryCount; i++) {
+        if (out > 0 && (hll->entries[out - 1] >> 8) == (hll->entries[i] >> 8)) hll->entries[out - 1] = hll->entries[i];
+        else hll->entries[out++] = hll->entries[i];
+    }
+    hll->entryCount = out;
+    hll->sortedCount = out;
+}
+
+static void _hllToDense(HyperLogLog hll) {
+    if (!hll->sparse) return;
+    hll->registers = (uint8_t*)xCalloc(_hllRegisters(hll), 1);
+    for (size_t i = 0; i < hll->entryCount; i++) {
+        uint32_t index = hll->entries[i] >> 8;
+        uint8_t rho = (uint8_t)(hll->entries[i] & 0xFF);
+        if (rho > hll->registers[index]) hll->registers[index] = rho;
+    }
+    xFree(hll->entries);
+    hll->entries = NULL;
+    hll->entryCount = 0;
+    hll->entryCapacity = 0;
+    hll->sortedCount = 0;
+    hll->sparse = false;
+}
+
+static void _hllInsert(HyperLogLog hll, uint32_t entry) {
+    if (!hll->sparse) {
+        uint32_t index = entry >> 8;
+        uint8_t rho = (uint8_t)(entry & 0xFF);
+        if (rho > hll->registers[index]) hll->registers[index] = rho;
+        return;
+    }
+
+    if (hll->entryCount == hll->entryCapacity) {
+        _hllCompact(hll);
+        if (hll->entryCount * sizeof(uint32_t) * 4 >= _hllRegisters(hll)) {
+            _hllToDense(hll);
+            _hllInsert(hll, entry);
+            return;
+        }
+        if (hll->entryCount + HLL_SPARSE_BUFFER > hll->entryCapacity) {
+            hll->entryCapacity = hll->entryCount * 2 + HLL_SPARSE_BUFFER;
+            hll->entries = (uint32_t*)xRealloc(hll->entries, hll->entryCapacity * sizeof(uint32_t));
+        }
+    }
+    hll->entries[hll->entryCount++] = entry;
+}
+
+static HyperLogLog _hllNew(uint8_t precision, uint64_t seed) {
+    HyperLogLog hll = (HyperLogLog)xMalloc(sizeof(HyperLogLogStruct));
+    hll->precision = precision;
+    hll->seed = seed;
+    hll->sparse = true;
+    hll->registers = NULL;
+    hll->entries = NULL;
+    hll->entryCount = 0;
+    hll->entryCapacity = 0;
+    hll->sortedCount = 0;
+    return hll;
+}
+
+HyperLogLog hllCreate(uint8_t precision) {
+    if (precision < HLL_MIN_PRECISION) precision = HLL_MIN_PRECISION;
+    if (precision > HLL_MAX_PRECISION) precision = HLL_MAX_PRECISION;
+    return _hllNew(precision, SKETCH_SEED);
+}
+
+void hllAddHash(HyperLogLog hll, uint64_t hash) {
+    if (hll) _hllInsert(hll, _hllEntry(hll, hash));
+}
+
+void hllAdd(HyperLogLog hll, const void* key, size_t len) {
+    if (!hll || !key) return;
+    hllAddHash(hll, hashBytes(key, len, hll->seed));
+}
+
+uint64_t hllCount(HyperLogLog hll) {
+    if (!hll) return 0;
+    double m = (double)_hllRegisters(hll);
+
+    if (hll->sparse) {
+        _hllCompact(hll);
+        if (hll->entryCount == 0) return 0;
+        return (uint64_t)llround(m * log(m / (m - (double)hll->entryCount)));
+    }
+
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (size_t i = 0; i < _hllRegisters(hll); i++) {
+        sum += ldexp(1.0, -hll->registers[i]);
+        zeros += hll->registers[i] == 0;
+    }
+
+    double alpha = hll->precision == 4 ? 0.673 : hll->precision == 5 ? 0.697 :
+                   hll->precision == 6 ? 0.709 : 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) estimate = m * log(m / (double)zeros);
+    return (uint64_t)llround(estimate);
+}
+
+bool hllMerge(HyperLogLog dest, HyperLogLog src) {
+    if (!dest || !src || dest->precision != src->precision || dest->seed != src->seed) return false;
+    if (dest == src) return true;
+
+    if (!src->sparse) {
+        _hllToDense(dest);
+        for (size_t i = 0; i < _hllRegisters(dest); i++)
+            if (src->registers[i] > dest->registers[i]) dest->registers[i] = src->registers[i];
+        return true;
+    }
+    for (size_t i = 0; i < src->entryCount; i++) _hllInsert(dest, src->entries[i]);
+    return true;
+}
+
+Array hllSerialize(HyperLogLog hll) {
+    if (!hll) return NULL;
+    Array out = array(1);
+    _bytesPut(out, _hllMagic, 4);
+    _bytesPut(out, &hll->precision, 1);
+    uint8_t sparse = hll->sparse;
+    _bytesPut(out, &sparse, 1);
+    _bytesPutU64(out, hll->seed);
+
+    if (hll->sparse) {
+        _hllCompact(hll);
+        _bytesPutU64(out, hll->entryCount);
+        _bytesPut(out, hll->entries, hll->entryCount * sizeof(uint32_t));
+    } else {
+        _bytesPut(out, hll->registers, _hllRegisters(hll));
+    }
+    return out;
+}
+
+HyperLogLog hllDeserialize(Array bytes) {
+    if (!bytes) return NULL;
+    ByteReader in = _bytesReader(bytes);
+    uint8_t precision, sparse;
+    uint64_t seed;
+    if (!_bytesMagic(&in, _hllMagic) || !_bytesGet(&in, &precision, 1) || !_bytesGet(&in, &sparse, 1) ||
+        !_bytesGetU64(&in, &seed) || precision < HLL_MIN_PRECISION || precision > HLL_MAX_PRECISION)
+        return NULL;
+
+    HyperLogLog hll = _hllNew(precision, seed);
+    bool ok;
+    if (sparse) {
+        uint64_t count;
+        ok = _bytesGetU64(&in, &count) && count <= in.left / sizeof(uint32_t);
+        if (ok) {
+            hll->entryCapacity = (size_t)count + HLL_SPARSE_BUFFER;
+            hll->entries = (uint32_t*)xMalloc(hll->entryCapacity * sizeof(uint32_t));
+            ok = _bytesGet(&in, hll->entries, (size_t)count * sizeof(uint32_t));
+            hll->entryCount = (size_t)count;
+            for (size_t i = 0; ok && i < hll->entryCount; i++)
+                ok = (hll->entries[i] >> 8) < _hllRegisters(hll);
+        }
+    } else {
+        hll->sparse = false;
+        hll->registers = (uint8_t*)xMalloc(_hllRegisters(hll));
+        ok = _bytesGet(&in, hll->registers, _hllRegisters(hll));
+    }
+    if (!ok) {
+        hllFree(hll);
+        return NULL;
+    }
+    return hll;
+}
+
+void hllFree(HyperLogLog hll) {
+    if (!hll) return;
+    xFree(hll->registers);
+    xFree(hll->entries);
+    xFree(hll);
+}
+
+static CountMinSketch _countMinNew(size_t width, size_t depth, uint64_t seed) {
+    CountMinSketch cms = (CountMinSketch)xMalloc(sizeof(CountMinSketchStruct));
+    cms->width = width;
+    cms->depth = depth;
+    cms->total = 0;
+    cms->seed = seed;
+    cms->counters = (uint64_t*)xCalloc(width * depth, sizeof(uint64_t));
+    return cms;
+}
+
+static inline size_t _countMinCell(CountMinSketch cms, uint64_t hash, size_t row) {
+    uint32_t h1 = (uint32_t)hash;
+    uint32_t h2 = (uint32_t)(hash >> 32) | 1;
+    return row * cms->width + (size_t)((h1 + (uint64_t)row * h2) % cms->width);
+}
+
+CountMinSketch countMinCreate(double epsilon, double delta) {
+    if (epsilon <= 0.0 || epsilon >= 1.0) epsilon = 0.001;
+    if (delta <= 0.0 || delta >= 1.0) delta = 0.01;
+    size_t width = (size_t)ceil(M_E / epsilon);
+    size_t depth = (size_t)ceil(log(1.0 / delta));
+    return _countMinNew(width, depth ? depth : 1, SKETCH_SEED);
+}
+
+void countMinAdd(CountMinSketch cms, const void* key, size_t len, uint64_t count) {
+    if (!cms || !key) return;
+    uint64_t hash = hashBytes(key, len, cms->seed);
+    for (size_t row = 0; row < cms->depth; row++) cms->counters[_countMinCell(cms, hash, row)] += count;
+    cms->total += count;
+}
+
+uint64_t countMinEstimate(CountMinSketch cms, const void* key, size_t len) {
+    if (!cms || !key) return 0;
+    uint64_t hash = hashBytes(key, len, cms->seed);
+    uint64_t estimate = UINT64_MAX;
+    for (size_t row = 0; row < cms->depth; row++) {
+        uint64_t value = cms->counters[_countMinCell(cms, hash, row)];
+        if (value < estimate) estimate = value;
+    }
+    return estimate;
+}
+
+bool countMinMerge(CountMinSketch dest, CountMinSketch src) {
+    if (!dest || !src || dest->width != src->width || dest->depth != src->depth || dest->seed != src->seed)
+        return false;
+    if (dest == src) return true;
+    for (size_t i = 0; i < dest->width * dest->depth; i++) dest->counters[i] += src->counters[i];
+    dest->total += src->total;
+    return true;
+}
+
+Array countMinSerialize(CountMinSketch cms) {
+    if (!cms) return NULL;
+    Array out = array(1);
+    _bytesPut(out, _cmsMagic, 4);
+    _bytesPutU64(out, cms->width);
+    _bytesPutU64(out, cms->depth);
+    _bytesPutU64(out, cms->total);
+    _bytesPutU64(out, cms->seed);
+    _bytesPut(out, cms->counters, cms->width * cms->depth * sizeof(uint64_t));
+    return out;
+}
+
+CountMinSketch countMinDeserialize(Array bytes) {
+    if (!bytes) return NULL;
+    ByteReader in = _bytesReader(bytes);
+    uint64_t width, depth, total, seed;
+    if (!_bytesMagic(&in, _cmsMagic) || !_bytesGetU64(&in, &width) || !_bytesGetU64(&in, &depth) ||
+        !_bytesGetU64(&in, &total) || !_bytesGetU64(&in, &seed) || width == 0 || depth == 0 ||
+        width > in.left / sizeof(uint64_t) / depth || width * depth * sizeof(uint64_t) != in.left)
+        return NULL;
+
+    CountMinSketch cms = _countMinNew((size_t)width, (size_t)depth, seed);
+    cms->total = total;
+    _bytesGet(&in, cms->counters, in.left);
+    return cms;
+}
+
+void countMinFree(CountMinSketch cms) {
+    if (!cms) return;
+    xFree(cms->counters);
+    xFree(cms);
+}
+
+static inline uint64_t _topKCount(TopK topk, size_t pos) {
+    return topk->items[topk->heap[pos]].count;
+}
+
+static void _topKSwap(TopK topk, size_t a, size_t b) {
+    uint32_t tmp = topk->heap[a];
+    topk->heap[a] = topk->heap[b];
+    topk->heap[b] = tmp;
+    topk->position[topk->heap[a]] = (uint32_t)a;
+    topk->position[topk->heap[b]] = (uint32_t)b;
+}
+
+static void _topKSiftUp(TopK topk, size_t pos) {
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (_topKCount(topk, parent) <= _topKCount(topk, pos)) break;
+        _topKSwap(topk, pos, parent);
+        pos = parent;
+    }
+}
+
+static void _topKSiftDown(TopK topk, size_t pos) {
+    for (;;) {
+        size_t smallest = pos;
+        size_t left = pos * 2 + 1;
+        size_t right = left + 1;
+        if (left < topk->size && _topKCount(topk, left) < _topKCount(topk, smallest)) smallest = left;
+        if (right < topk->size && _topKCount(topk, right) < _topKCount(topk, smallest)) smallest = right;
+        if (smallest == pos) return;
+        _topKSwap(topk, pos, smallest);
+        pos = smallest;
+    }
+}
+
+static void _topKSetKey(TopKItem* item, const void* key, size_t len) {
+    item->key = (char*)xMalloc(len + 1);
+    memcpy(item->key, key, len);
+    item->key[len] = '\0';
+    item->len = len;
+}
+
+static void _topKAdd(TopK topk, const void* key, size_t len, uint64_t count, uint64_t error) {
+    uint32_t* found = (uint32_t*)mapGetStr(topk->index, (const char*)key, len);
+    if (found) {
+        TopKItem* item = &topk->items[*found];
+        item->count += count;
+        item->error += error;
+        _topKSiftDown(topk, topk->position[*found]);
+        return;
+    }
+
+    uint32_t slot;
+    uint64_t floor = 0;
+    if (topk->size < topk->k) {
+        slot = (uint32_t)topk->size;
+        topk->heap[topk->size] = slot;
+        topk->position[slot] = (uint32_t)topk->size;
+        topk->size++;
+    } else {
+        slot = topk->heap[0];
+        TopKItem* evicted = &topk->items[slot];
+        floor = evicted->count;
+        mapRemoveStr(topk->index, evicted->key, evicted->len, NULL);
+        xFree(evicted->key);
+    }
+
+    TopKItem* item = &topk->items[slot];
+    _topKSetKey(item, key, len);
+    item->count = floor + count;
+    item->error = floor + error;
+    mapPutStr(topk->index, item->key, len, &slot);
+    if (floor) _topKSiftDown(topk, topk->position[slot]);
+    else _topKSiftUp(topk, topk->position[slot]);
+}
+
+TopK topKCreate(size_t k) {
+    if (k == 0) k = 1;
+    if (k > TOPK_MAX_K) return NULL;
+    TopK topk = (TopK)xMalloc(sizeof(TopKStruct));
+    if (!topk) return NULL;
+    topk->k = k;
+    topk->size = 0;
+    topk->items = (TopKItem*)xCalloc(k, sizeof(TopKItem));
+    topk->heap = (uint32_t*)xMalloc(k * sizeof(uint32_t));
+    topk->position = (uint32_t*)xMalloc(k * sizeof(uint32_t));
+    topk->index = mapCreateStr(sizeof(uint32_t), k);
+    if (!topk->items || !topk->heap || !topk->position || !topk->index) {
+        topKFree(topk);
+        return NULL;
+    }
+    return topk;
+}
+
+void topKAdd(TopK topk, const void* key, size_t len, uint64_t count) {
+    if (!topk || !key || count == 0) return;
+    _topKAdd(topk, key, len, count, 0);
+}
+
+static int _compareItems(const void* a, const void* b) {
+    const TopKItem* x = (const TopKItem*)a;
+    const TopKItem* y = (const TopKItem*)b;
+    if (x->count != y->count) return x->count < y->count ? 1 : -1;
+    return x->error < y->error ? -1 : x->error > y->error;
+}
+
+Array topKList(TopK topk) {
+    if (!topk) return NULL;
+    Array out = arrayFromPtr(topk->items, topk->size, sizeof(TopKItem));
+    arraySort(out, _compareItems);
+    return out;
+}
+
+bool topKMerge(TopK dest, TopK src) {
+    if (!dest || !src) return false;
+    if (dest == src) return true;
+    for (size_t i = 0; i < src->size; i++) {
+        TopKItem* item = &src->items[i];
+        _topKAdd(dest, item->key, item->len, item->count, item->error);
+    }
+    return true;
+}
+
+Array topKSerialize(TopK topk) {
+    if (!topk) return NULL;
+    Array out = array(1);
+    _bytesPut(out, _topKMagic, 4);
+    _bytesPutU64(out, topk->k);
+    _bytesPutU64(out, topk->size);
+    for (size_t i = 0; i < topk->size; i++) {
+        TopKItem* item = &topk->items[i];
+        _bytesPutU64(out, item->len);
+        _bytesPutU64(out, item->count);
+        _bytesPutU64(out, item->error);
+        _bytesPut(out, item->key, item->len);
+    }
+    return out;
+}
+
+TopK topKDeserialize(Array bytes) {
+    if (!bytes) return NULL;
+    ByteReader in = _bytesReader(bytes);
+    uint64_t k, size;
+    if (!_bytesMagic(&in, _topKMagic) || !_bytesGetU64(&in, &k) || !_bytesGetU64(&in, &size) ||
+        k == 0 || k > TOPK_MAX_K || size > k || size > in.left / (3 * sizeof(uint64_t)))
+        return NULL;
+
+    TopK topk = topKCreate((size_t)k);
+    if (!topk) return NULL;
+    for (uint64_t i = 0; i < size; i++) {
+        uint64_t len, count, error;
+        if (!_bytesGetU64(&in, &len) || !_bytesGetU64(&in, &count) || !_bytesGetU64(&in, &error) ||
+            len > in.left || count == 0) {
+            topKFree(topk);
+            return NULL;
+        }
+        _topKAdd(topk, in.data, (size_t)len, count, error);
+        in.data += len;
+        in.left -= len;
+    }
+    return topk;
+}
+
+void topKFree(TopK topk) {
+    if (!topk) return;
+    for (size_t i = 0; i < topk->size; i++) xFree(topk->items[i].key);
+    xFree(topk->items);
+    xFree(topk->heap);
+    xFree(topk->position);
+    mapFree(topk->index, NULL, NULL);
+    xFree(topk);
+}
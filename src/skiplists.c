@@ -0,0 +1,280 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../include/skiplists.h"
+#include "../include/pointers.h"
+
+#define SKIPLIST_MARK    ((uintptr_t)1)
+#define SKIPLIST_LINKED  1u
+#define SKIPLIST_REMOVED 2u
+
+static inline SkipListNode* _ref(uintptr_t link) {
+    return (SkipListNode*)(link & ~SKIPLIST_MARK);
+}
+
+static inline bool _marked(uintptr_t link) {
+    return (link & SKIPLIST_MARK) != 0;
+}
+
+static inline size_t _inlineOffset(uint32_t level) {
+    size_t offset = sizeof(SkipListNode) + level * sizeof(uintptr_t);
+    return (offset + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+}
+
+static inline void* _inlineData(SkipListNode* n) {
+    return (uint8_t*)n + _inlineOffset(n->level);
+}
+
+static uint32_t _randomLevel(void) {
+    static _Thread_local uint64_t state;
+    if (!state) state = (uint64_t)(uintptr_t)&state * 0x9E3779B97F4A7C15ULL | 1;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    uint64_t r = state;
+    uint32_t level = 1;
+    while ((r & 3) == 0 && level < SKIPLIST_MAX_LEVEL) {
+        level++;
+        r >>= 2;
+    }
+    return level;
+}
+
+static SkipListNode* _nodeNew(SkipList sl, uint32_t level, const void* data) {
+    size_t bytes = _inlineOffset(level) + sl->esize;
+    SkipListNode* n = (SkipListNode*)xMalloc(bytes);
+    n->level = level;
+    atomic_init(&n->state, 0);
+    for (uint32_t i = 0; i < level; i++) atomic_init(&n->next[i], 0);
+    void* storage = _inlineData(n);
+    if (data) memcpy(storage, data, sl->esize);
+    atomic_init(&n->data, storage);
+    return n;
+}
+
+static void _nodeFree(SkipListNode* n, void (*freeFn)(void*)) {
+    void* data = atomic_load_explicit(&n->data, memory_order_relaxed);
+    if (freeFn) freeFn(data);
+    if (data != _inlineData(n)) xFree(data);
+    xFree(n);
+}
+
+static void _nodeRetired(void* n) {
+    _nodeFree((SkipListNode*)n, NULL);
+}
+
+static inline void _writeEnd(SkipList sl) {
+    epochExit();
+    epochReclaim(&sl->retired);
+}
+
+static inline int _compare(SkipList sl, SkipListNode* n, const void* key) {
+    return sl->cmp(atomic_load_explicit(&n->data, memory_order_acquire), key);
+}
+
+static bool _find(SkipList sl, const void* key, SkipListNode** preds, SkipListNode** succs) {
+retry:;
+    SkipListNode* pred = sl->head;
+    SkipListNode* curr = NULL;
+    for (int level = SKIPLIST_MAX_LEVEL - 1; level >= 0; level--) {
+        curr = _ref(atomic_load(&pred->next[level]));
+        while (curr) {
+            uintptr_t succ = atomic_load(&curr->next[level]);
+            while (_marked(succ)) {
+                uintptr_t expected = (uintptr_t)curr;
+                if (!atomic_compare_exchange_strong(&pred->next[level], &expected, succ & ~SKIPLIST_MARK))
+                    goto retry;
+                curr = _ref(succ);
+                if (!curr) break;
+                succ = atomic_load(&curr->next[level]);
+            }
+            if (curr && _compare(sl, curr, key) < 0) {
+                pred = curr;
+                curr = _ref(succ);
+            } else {
+                break;
+            }
+        }
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+    return curr && _compare(sl, curr, key) == 0;
+}
+
+static void _finishRemoval(SkipList sl, SkipListNode* n, unsigned bit) {
+    if (!(atomic_fetch_or(&n->state, bit) & (bit == SKIPLIST_LINKED ? SKIPLIST_REMOVED : SKIPLIST_LINKED)))
+        return;
+    SkipListNode* preds[SKIPLIST_MAX_LEVEL];
+    SkipListNode* succs[SKIPLIST_MAX_LEVEL];
+    _find(sl, atomic_load(&n->data), preds, succs);
+    epochRetire(&sl->retired, n, _nodeRetired);
+}
+
+SkipList skipListCreate(size_t esize, int (*cmp)(const void*, const void*)) {
+    SkipList sl = (SkipList)xMalloc(sizeof(SkipListStruct));
+    sl->esize = esize;
+    sl->cmp = cmp;
+    sl->head = _nodeNew(sl, SKIPLIST_MAX_LEVEL, NULL);
+    atomic_init(&sl->count, 0);
+    epochListInit(&sl->retired);
+    return sl;
+}
+
+void skipListInsert(SkipList sl, void* data) {
+    if (!sl || !data) return;
+    SkipListNode* preds[SKIPLIST_MAX_LEVEL];
+    SkipListNode* succs[SKIPLIST_MAX_LEVEL];
+    uint32_t level = _randomLevel();
+    SkipListNode* n = NULL;
+
+    epochEnter();
+    for (;;) {
+        if (_find(sl, data, preds, succs)) {
+            void* block = xMalloc(sl->esize);
+            memcpy(block, data, sl->esize);
+            void* old = atomic_exchange(&succs[0]->data, block);
+            if (old != _inlineData(succs[0])) epochRetire(&sl->retired, old, xFree);
+            if (n) xFree(n);
+            _writeEnd(sl);
+            return;
+        }
+
+        if (!n) n = _nodeNew(sl, level, data);
+        for (uint32_t i = 0; i < level; i++) atomic_store_explicit(&n->next[i], (uintptr_t)succs[i], memory_order_relaxed);
+        uintptr_t expected = (uintptr_t)succs[0];
+        if (atomic_compare_exchange_strong(&preds[0]->next[0], &expected, (uintptr_t)n)) break;
+    }
+    atomic_fetch_add(&sl->count, 1);
+
+    for (uint32_t i = 1; i < level; i++) {
+        for (;;) {
+            uintptr_t succ = atomic_load(&n->next[i]);
+            if (_marked(succ)) goto linked;
+            if (succ != (uintptr_t)succs[i] && !atomic_compare_exchange_strong(&n->next[i], &succ, (uintptr_t)succs[i]))
+                goto linked;
+            uintptr_t expected = (uintptr_t)succs[i];
+            if (atomic_compare_exchange_strong(&preds[i]->next[i], &expected, (uintptr_t)n)) break;
+            if (!_find(sl, data, preds, succs) || succs[0] != n) goto linked;
+        }
+    }
+linked:
+    _finishRemoval(sl, n, SKIPLIST_LINKED);
+    _writeEnd(sl);
+}
+
+static SkipListNode* _search(SkipList sl, const void* key) {
+    SkipListNode* pred = sl->head;
+    SkipListNode* curr = NULL;
+    for (int level = SKIPLIST_MAX_LEVEL - 1; level >= 0; level--) {
+        curr = _ref(atomic_load(&pred->next[level]));
+        while (curr) {
+            uintptr_t succ = atomic_load(&curr->next[level]);
+            while (_marked(succ) && (curr = _ref(succ))) succ = atomic_load(&curr->next[level]);
+            if (curr && _compare(sl, curr, key) < 0) {
+                pred = curr;
+                curr = _ref(succ);
+            } else {
+                break;
+            }
+        }
+    }
+    if (curr && _compare(sl, curr, key) == 0 && !_marked(atomic_load(&curr->next[0]))) return curr;
+    return NULL;
+}
+
+bool skipListGet(SkipList sl, void* key, void* out) {
+    if (!sl || !key) return false;
+    epochEnter();
+    SkipListNode* n = _search(sl, key);
+    if (n && out) memcpy(out, atomic_load_explicit(&n->data, memory_order_acquire), sl->esize);
+    epochExit();
+    return n != NULL;
+}
+
+bool skipListContains(SkipList sl, void* key) {
+    return skipListGet(sl, key, NULL);
+}
+
+bool skipListRemove(SkipList sl, void* key) {
+    if (!sl || !key) return false;
+    SkipListNode* preds[SKIPLIST_MAX_LEVEL];
+    SkipListNode* succs[SKIPLIST_MAX_LEVEL];
+
+    epochEnter();
+    if (!_find(sl, key, preds, succs)) {
+        epochExit();
+        return false;
+    }
+
+    SkipListNode* n = succs[0];
+    for (uint32_t i = n->level - 1; i >= 1; i--) {
+        uintptr_t succ = atomic_load(&n->next[i]);
+        while (!_marked(succ) && !atomic_compare_exchange_weak(&n->next[i], &succ, succ | SKIPLIST_MARK));
+    }
+
+    uintptr_t succ = atomic_load(&n->next[0]);
+    while (!_marked(succ)) {
+        if (atomic_compare_exchange_weak(&n->next[0], &succ, succ | SKIPLIST_MARK)) {
+            atomic_fetch_sub(&sl->count, 1);
+            _finishRemoval(sl, n, SKIPLIST_REMOVED);
+            _writeEnd(sl);
+            return true;
+        }
+    }
+    epochExit();
+    return false;
+}
+
+size_t skipListRange(SkipList sl, void* lo, void* hi, bool (*fn)(void* data, void* ctx), void* ctx) {
+    if (!sl || !fn) return 0;
+    size_t visited = 0;
+
+    epochEnter();
+    SkipListNode* curr;
+    if (lo) {
+        SkipListNode* pred = sl->head;
+        for (int level = SKIPLIST_MAX_LEVEL - 1; level >= 0; level--) {
+            curr = _ref(atomic_load(&pred->next[level]));
+            while (curr && _compare(sl, curr, lo) < 0) {
+                pred = curr;
+                curr = _ref(atomic_load(&curr->next[level]));
+            }
+        }
+        curr = _ref(atomic_load(&pred->next[0]));
+    } else {
+        curr = _ref(atomic_load(&sl->head->next[0]));
+    }
+
+    while (curr) {
+        uintptr_t succ = atomic_load(&curr->next[0]);
+        if (!_marked(succ)) {
+            void* data = atomic_load_explicit(&curr->data, memory_order_acquire);
+            if (lo && sl->cmp(data, lo) < 0) {
+                curr = _ref(succ);
+                continue;
+            }
+            if (hi && sl->cmp(data, hi) > 0) break;
+            visited++;
+            if (!fn(data, ctx)) break;
+        }
+        curr = _ref(succ);
+    }
+    epochExit();
+    return visited;
+}
+
+size_t skipListSize(SkipList sl) {
+    return sl ? atomic_load(&sl->count) : 0;
+}
+
+void skipListFree(SkipList sl, void (*freeFn)(void*)) {
+    if (!sl) return;
+    SkipListNode* n = _ref(atomic_load(&sl->head->next[0]));
+    while (n) {
+        SkipListNode* next = _ref(atomic_load(&n->next[0]));
+        _nodeFree(n, _marked(atomic_load(&n->next[0])) ? NULL : freeFn);
+        n = next;
+    }
+    epochDrain(&sl->retired);
+    xFree(sl->head);
+    xFree(sl);
+}
@@ -1,90 +1,294 @@
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include "../include/trees.h"
 #include "../include/pointers.h"
 
+#ifndef TREE_SPLAY_DEPTH
+#define TREE_SPLAY_DEPTH 8
+#endif
+
+#define TREE_TREAP_HIT ((uint32_t)1 << 16)
+
+static inline uint32_t _nodePriority(TreeNode* n) {
+    return (uint32_t)(((uintptr_t)n * 0x9E3779B97F4A7C15ULL) >> 48);
+}
+
 static TreeNode* _nodeNew(void* data, size_t esize) {
-    TreeNode* n = (TreeNode*)xMalloc(sizeof(TreeNode));
-    n->data = xMalloc(esize);
+    TreeNode* n = (TreeNode*)xMalloc(sizeof(TreeNode) + esize);
+    n->data = n->storage;
     memcpy(n->data, data, esize);
     n->left = NULL;
     n->right = NULL;
+    n->parent = NULL;
+    n->size = 1;
+    n->height = 1;
+    n->priority = _nodePriority(n);
     return n;
 }
 
-static void _nodeFreeRecursive(TreeNode* n, void (*freeFn)(void*)) {
-    if (!n) return;
-    _nodeFreeRecursive(n->left, freeFn);
-    _nodeFreeRecursive(n->right, freeFn);
-    
-    if (freeFn && n->data) {
-        freeFn(n->data);
+static inline bool _inSlab(Tree t, TreeNode* n) {
+    return t->slab && (uint8_t*)n >= (uint8_t*)t->slab && (uint8_t*)n < (uint8_t*)t->slab + t->slabBytes;
+}
+
+static inline void _nodeRelease(Tree t, TreeNode* n) {
+    if (_inSlab(t, n)) t->slabLive--;
+    else xFree(n);
+}
+
+static void _nodeFreeAll(Tree t, TreeNode* n, void (*freeFn)(void*)) {
+    while (n) {
+        if (n->left) {
+            TreeNode* left = n->left;
+            n->left = left->right;
+            left->right = n;
+            n = left;
+            continue;
+        }
+        TreeNode* next = n->right;
+        if (freeFn && n->data) {
+            freeFn(n->data);
+        }
+        _nodeRelease(t, n);
+        n = next;
     }
-    xFree(n->data);
-    xFree(n);
 }
 
-static int _treeHeightRecursive(TreeNode* n) {
-    if (!n) return 0;
-    int l = _treeHeightRecursive(n->left);
-    int r = _treeHeightRecursive(n->right);
-    return (l > r ? l : r) + 1;
+static inline int _height(TreeNode* n) {
+    return n ? n->height : 0;
 }
 
-static void _treeToArrRecursive(TreeNode* n, Array arr, int mode) {
-    if (!n) return;
-    
-    if (mode == 1) arrayAdd(arr, n->data);
-    
-    _treeToArrRecursive(n->left, arr, mode);
-    
-    if (mode == 0) arrayAdd(arr, n->data);
-    
-    _treeToArrRecursive(n->right, arr, mode);
-    
-    if (mode == 2) arrayAdd(arr, n->data);
+static inline size_t _size(TreeNode* n) {
+    return n ? n->size : 0;
+}
+
+static inline void _updateNode(TreeNode* n) {
+    int l = _height(n->left);
+    int r = _height(n->right);
+    n->height = (l > r ? l : r) + 1;
+    n->size = _size(n->left) + _size(n->right) + 1;
+}
+
+static TreeNode* _rotateLeft(TreeNode* n) {
+    TreeNode* r = n->right;
+    n->right = r->left;
+    if (n->right) n->right->parent = n;
+    r->left = n;
+    r->parent = n->parent;
+    n->parent = r;
+    _updateNode(n);
+    _updateNode(r);
+    return r;
+}
+
+static TreeNode* _rotateRight(TreeNode* n) {
+    TreeNode* l = n->left;
+    n->left = l->right;
+    if (n->left) n->left->parent = n;
+    l->right = n;
+    l->parent = n->parent;
+    n->parent = l;
+    _updateNode(n);
+    _updateNode(l);
+    return l;
+}
+
+static TreeNode* _rebalance(TreeNode* n) {
+    _updateNode(n);
+    int balance = _height(n->left) - _height(n->right);
+    if (balance > 1) {
+        if (_height(n->left->left) < _height(n->left->right)) {
+            n->left = _rotateLeft(n->left);
+            n->left->parent = n;
+        }
+        return _rotateRight(n);
+    }
+    if (balance < -1) {
+        if (_height(n->right->right) < _height(n->right->left)) {
+            n->right = _rotateRight(n->right);
+            n->right->parent = n;
+        }
+        return _rotateLeft(n);
+    }
+    return n;
+}
+
+static void _treeToArr(TreeNode* n, Array arr, int mode) {
+    TreeNode* prev = NULL;
+    while (n) {
+        bool down = prev == n->parent;
+        if (down) {
+            if (mode == 1) arrayAdd(arr, n->data);
+            if (n->left) {
+                prev = n;
+                n = n->left;
+                continue;
+            }
+        }
+        if (down || prev == n->left) {
+            if (mode == 0) arrayAdd(arr, n->data);
+            if (n->right) {
+                prev = n;
+                n = n->right;
+                continue;
+            }
+        }
+        if (mode == 2) arrayAdd(arr, n->data);
+        prev = n;
+        n = n->parent;
+    }
 }
 
 Tree treeCreate(size_t esize, int (*cmp)(const void*, const void*)) {
+    return treeCreateWithEngine(esize, cmp, TREE_DEFAULT_ENGINE);
+}
+
+Tree treeCreateWithEngine(size_t esize, int (*cmp)(const void*, const void*), TreeEngine engine) {
     Tree t = (Tree)xMalloc(sizeof(TreeStruct));
     t->root = NULL;
     t->esize = esize;
     t->count = 0;
+    t->engine = engine;
     t->cmp = cmp;
+    t->slab = NULL;
+    t->slabBytes = 0;
+    t->slabLive = 0;
     return t;
 }
 
-void treeInsert(Tree t, void* data) {
-    if (!t) return;
-    
-    if (t->root == NULL) {
-        t->root = _nodeNew(data, t->esize);
+static TreeNode* _insertNode(Tree t, TreeNode* root, void* data) {
+    if (root == NULL) {
         t->count++;
-        return;
+        return _nodeNew(data, t->esize);
     }
 
-    TreeNode* current = t->root;
-    while (true) {
-        int r = t->cmp(data, current->data);
-        if (r < 0) {
-            if (current->left == NULL) {
-                current->left = _nodeNew(data, t->esize);
-                t->count++;
-                break;
-            }
-            current = current->left;
-        } else if (r > 0) {
-            if (current->right == NULL) {
-                current->right = _nodeNew(data, t->esize);
-                t->count++;
-                break;
-            }
-            current = current->right;
-        } else {
-            memcpy(current->data, data, t->esize);
-            break;
+    int r = t->cmp(data, root->data);
+    if (r < 0) {
+        root->left = _insertNode(t, root->left, data);
+        root->left->parent = root;
+    } else if (r > 0) {
+        root->right = _insertNode(t, root->right, data);
+        root->right->parent = root;
+    } else {
+        memcpy(root->data, data, t->esize);
+        return root;
+    }
+    return _rebalance(root);
+}
+
+static TreeNode* _findMin(TreeNode* n) {
+    while (n->left != NULL) n = n->left;
+    return n;
+}
+
+static void _fixUpward(TreeNode* n) {
+    while (n) {
+        _updateNode(n);
+        n = n->parent;
+    }
+}
+
+static void _rotateUp(Tree t, TreeNode* x) {
+    TreeNode* p = x->parent;
+    TreeNode* g = p->parent;
+    if (p->left == x) {
+        p->left = x->right;
+        if (x->right) x->right->parent = p;
+        x->right = p;
+    } else {
+        p->right = x->left;
+        if (x->left) x->left->parent = p;
+        x->left = p;
+    }
+    p->parent = x;
+    x->parent = g;
+    if (!g) t->root = x;
+    else if (g->left == p) g->left = x;
+    else g->right = x;
+    _updateNode(p);
+    _updateNode(x);
+}
+
+static void _splay(Tree t, TreeNode* x) {
+    while (x->parent) {
+        TreeNode* p = x->parent;
+        TreeNode* g = p->parent;
+        if (g) _rotateUp(t, (g->left == p) == (p->left == x) ? p : x);
+        _rotateUp(t, x);
+    }
+}
+
+static void _treapTouch(Tree t, TreeNode* n) {
+    if (n->priority <= UINT32_MAX - TREE_TREAP_HIT) n->priority += TREE_TREAP_HIT;
+    while (n->parent && n->parent->priority < n->priority) _rotateUp(t, n);
+    _fixUpward(n->parent);
+}
+
+static TreeNode* _linkNode(Tree t, void* data) {
+    TreeNode* parent = NULL;
+    TreeNode** link = &t->root;
+    while (*link) {
+        parent = *link;
+        int r = t->cmp(data, parent->data);
+        if (r == 0) {
+            memcpy(parent->data, data, t->esize);
+            return parent;
         }
+        link = r < 0 ? &parent->left : &parent->right;
     }
+    TreeNode* n = _nodeNew(data, t->esize);
+    n->parent = parent;
+    *link = n;
+    t->count++;
+    _fixUpward(parent);
+    return n;
+}
+
+static inline void _replaceChild(Tree t, TreeNode* old, TreeNode* child) {
+    TreeNode* parent = old->parent;
+    if (child) child->parent = parent;
+    if (!parent) t->root = child;
+    else if (parent->left == old) parent->left = child;
+    else parent->right = child;
+}
+
+static TreeNode* _unlinkNode(Tree t, TreeNode* n, void (*freeFn)(void*)) {
+    if (freeFn) freeFn(n->data);
+    if (t->engine == TREE_ENGINE_TREAP) {
+        while (n->left && n->right) _rotateUp(t, n->left->priority > n->right->priority ? n->left : n->right);
+    } else if (n->left && n->right) {
+        TreeNode* successor = _findMin(n->right);
+        TreeNode* fix = successor->parent == n ? successor : successor->parent;
+        _replaceChild(t, successor, successor->right);
+        successor->left = n->left;
+        successor->right = n->right;
+        successor->left->parent = successor;
+        if (successor->right) successor->right->parent = successor;
+        _replaceChild(t, n, successor);
+        _nodeRelease(t, n);
+        t->count--;
+        _fixUpward(fix);
+        return fix;
+    }
+    TreeNode* child = n->left ? n->left : n->right;
+    TreeNode* parent = n->parent;
+    _replaceChild(t, n, child);
+    _nodeRelease(t, n);
+    t->count--;
+    _fixUpward(parent);
+    return parent;
+}
+
+void treeInsert(Tree t, void* data) {
+    if (!t) return;
+    if (t->engine != TREE_ENGINE_AVL) {
+        TreeNode* n = _linkNode(t, data);
+        if (t->engine == TREE_ENGINE_SPLAY) _splay(t, n);
+        else if (t->engine == TREE_ENGINE_TREAP) _treapTouch(t, n);
+        return;
+    }
+    t->root = _insertNode(t, t->root, data);
+    t->root->parent = NULL;
 }
 
 bool treeContains(Tree t, void* data) {
@@ -94,67 +298,86 @@ bool treeContains(Tree t, void* data) {
 void* treeSearch(Tree t, void* data) {
     if (!t || !t->root) return NULL;
     TreeNode* current = t->root;
+    TreeNode* last = NULL;
+    size_t depth = 0;
     while (current) {
         int r = t->cmp(data, current->data);
-        if (r == 0) return current->data;
-        else if (r < 0) current = current->left;
+        if (r == 0) break;
+        last = current;
+        depth++;
+        if (r < 0) current = current->left;
         else current = current->right;
     }
-    return NULL;
+    if (t->engine == TREE_ENGINE_SPLAY && depth > TREE_SPLAY_DEPTH) _splay(t, current ? current : last);
+    else if (t->engine == TREE_ENGINE_TREAP && current) _treapTouch(t, current);
+    return current ? current->data : NULL;
 }
 
-static TreeNode* _findMin(TreeNode* n) {
-    while (n->left != NULL) n = n->left;
-    return n;
-}
-
-static TreeNode* _deleteNode(TreeNode* root, void* data, size_t esize, int (*cmp)(const void*, const void*), bool* decreased, void (*freeFn)(void*)) {
+static TreeNode* _deleteNode(Tree t, TreeNode* root, void* data, bool* decreased, void (*freeFn)(void*)) {
     if (root == NULL) return root;
 
-    int r = cmp(data, root->data);
+    int r = t->cmp(data, root->data);
 
     if (r < 0) {
-        root->left = _deleteNode(root->left, data, esize, cmp, decreased, freeFn);
+        root->left = _deleteNode(t, root->left, data, decreased, freeFn);
+        if (root->left) root->left->parent = root;
     } else if (r > 0) {
-        root->right = _deleteNode(root->right, data, esize, cmp, decreased, freeFn);
+        root->right = _deleteNode(t, root->right, data, decreased, freeFn);
+        if (root->right) root->right->parent = root;
     } else {
         *decreased = true;
         
         if (root->left == NULL) {
             TreeNode* temp = root->right;
             if (freeFn) freeFn(root->data);
-            xFree(root->data);
-            xFree(root);
+            _nodeRelease(t, root);
             return temp;
         } else if (root->right == NULL) {
             TreeNode* temp = root->left;
             if (freeFn) freeFn(root->data);
-            xFree(root->data);
-            xFree(root);
+            _nodeRelease(t, root);
             return temp;
         }
         
         TreeNode* temp = _findMin(root->right);
         
         if (freeFn) freeFn(root->data);
-        memcpy(root->data, temp->data, esize);
+        memcpy(root->data, temp->data, t->esize);
         
         bool dummy;
-        root->right = _deleteNode(root->right, temp->data, esize, cmp, &dummy, NULL); 
+        root->right = _deleteNode(t, root->right, temp->data, &dummy, NULL); 
+        if (root->right) root->right->parent = root;
     }
-    return root;
+    return _rebalance(root);
 }
 
 void treeRemove(Tree t, void* data, void (*freeFn)(void*)) {
     if (!t || !t->root) return;
+    if (t->engine != TREE_ENGINE_AVL) {
+        TreeNode* current = t->root;
+        while (current) {
+            int r = t->cmp(data, current->data);
+            if (r == 0) break;
+            current = r < 0 ? current->left : current->right;
+        }
+        if (!current) return;
+        TreeNode* parent = _unlinkNode(t, current, freeFn);
+        if (t->engine == TREE_ENGINE_SPLAY && parent) _splay(t, parent);
+        return;
+    }
     bool decreased = false;
-    t->root = _deleteNode(t->root, data, t->esize, t->cmp, &decreased, freeFn);
+    t->root = _deleteNode(t, t->root, data, &decreased, freeFn);
+    if (t->root) t->root->parent = NULL;
     if (decreased) t->count--;
 }
 
 void treeClear(Tree t, void (*freeFn)(void*)) {
     if (!t) return;
-    _nodeFreeRecursive(t->root, freeFn);
+    _nodeFreeAll(t, t->root, freeFn);
+    xFree(t->slab);
+    t->slab = NULL;
+    t->slabBytes = 0;
+    t->slabLive = 0;
     t->root = NULL;
     t->count = 0;
 }
@@ -170,7 +393,7 @@ size_t treeSize(Tree t) {
 }
 
 size_t treeHeight(Tree t) {
-    return t ? _treeHeightRecursive(t->root) : 0;
+    return t ? (size_t)_height(t->root) : 0;
 }
 
 void* treeMin(Tree t) {
@@ -190,20 +413,226 @@ void* treeMax(Tree t) {
 Array treeToInOrder(Tree t) {
     if (!t) return NULL;
     Array arr = array(t->esize);
-    _treeToArrRecursive(t->root, arr, 0);
+    _treeToArr(t->root, arr, 0);
     return arr;
 }
 
 Array treeToPreOrder(Tree t) {
     if (!t) return NULL;
     Array arr = array(t->esize);
-    _treeToArrRecursive(t->root, arr, 1);
+    _treeToArr(t->root, arr, 1);
     return arr;
 }
 
 Array treeToPostOrder(Tree t) {
     if (!t) return NULL;
     Array arr = array(t->esize);
-    _treeToArrRecursive(t->root, arr, 2);
+    _treeToArr(t->root, arr, 2);
     return arr;
-}
\ No newline at end of file
+}
+
+static TreeNode* _floorNode(Tree t, void* data) {
+    TreeNode* cur = t->root;
+    TreeNode* best = NULL;
+    while (cur) {
+        int r = t->cmp(data, cur->data);
+        if (r == 0) return cur;
+        if (r > 0) {
+            best = cur;
+            cur = cur->right;
+        } else {
+            cur = cur->left;
+        }
+    }
+    return best;
+}
+
+static TreeNode* _ceilingNode(Tree t, void* data) {
+    TreeNode* cur = t->root;
+    TreeNode* best = NULL;
+    while (cur) {
+        int r = t->cmp(data, cur->data);
+        if (r == 0) return cur;
+        if (r < 0) {
+            best = cur;
+            cur = cur->left;
+        } else {
+            cur = cur->right;
+        }
+    }
+    return best;
+}
+
+static TreeNode* _successor(TreeNode* n) {
+    if (n->right) return _findMin(n->right);
+    while (n->parent && n->parent->right == n) n = n->parent;
+    return n->parent;
+}
+
+static TreeNode* _predecessor(TreeNode* n) {
+    if (n->left) {
+        n = n->left;
+        while (n->right) n = n->right;
+        return n;
+    }
+    while (n->parent && n->parent->left == n) n = n->parent;
+    return n->parent;
+}
+
+void* treeSelect(Tree t, size_t k) {
+    if (!t || k >= t->count) return NULL;
+    TreeNode* cur = t->root;
+    while (cur) {
+        size_t left = _size(cur->left);
+        if (k == left) return cur->data;
+        if (k < left) {
+            cur = cur->left;
+        } else {
+            k -= left + 1;
+            cur = cur->right;
+        }
+    }
+    return NULL;
+}
+
+size_t treeRank(Tree t, void* data) {
+    if (!t || !data) return 0;
+    TreeNode* cur = t->root;
+    size_t rank = 0;
+    while (cur) {
+        int r = t->cmp(data, cur->data);
+        if (r <= 0) {
+            if (r == 0) return rank + _size(cur->left);
+            cur = cur->left;
+        } else {
+            rank += _size(cur->left) + 1;
+            cur = cur->right;
+        }
+    }
+    return rank;
+}
+
+void* treeFloor(Tree t, void* data) {
+    if (!t || !data) return NULL;
+    TreeNode* n = _floorNode(t, data);
+    return n ? n->data : NULL;
+}
+
+void* treeCeiling(Tree t, void* data) {
+    if (!t || !data) return NULL;
+    TreeNode* n = _ceilingNode(t, data);
+    return n ? n->data : NULL;
+}
+
+TreeIterator treeIterator(Tree t) {
+    TreeIterator it = { t, NULL };
+    if (t && t->root) it.node = _findMin(t->root);
+    return it;
+}
+
+TreeIterator treeIteratorLast(Tree t) {
+    TreeIterator it = { t, NULL };
+    if (!t || !t->root) return it;
+    it.node = t->root;
+    while (it.node->right) it.node = it.node->right;
+    return it;
+}
+
+TreeIterator treeIterSeek(Tree t, void* lo) {
+    if (!lo) return treeIterator(t);
+    TreeIterator it = { t, t ? _ceilingNode(t, lo) : NULL };
+    return it;
+}
+
+TreeIterator treeIterSeekLast(Tree t, void* hi) {
+    if (!hi) return treeIteratorLast(t);
+    TreeIterator it = { t, t ? _floorNode(t, hi) : NULL };
+    return it;
+}
+
+void* treeNext(TreeIterator* it) {
+    if (!it || !it->node) return NULL;
+    TreeNode* n = it->node;
+    it->node = _successor(n);
+    return n->data;
+}
+
+void* treePrev(TreeIterator* it) {
+    if (!it || !it->node) return NULL;
+    TreeNode* n = it->node;
+    it->node = _predecessor(n);
+    return n->data;
+}
+
+size_t treeRange(Tree t, void* lo, void* hi, bool (*fn)(void* data, void* ctx), void* ctx) {
+    if (!t || !fn) return 0;
+    TreeIterator it = treeIterSeek(t, lo);
+    size_t visited = 0;
+    void* data;
+    while ((data = treeNext(&it))) {
+        if (hi && t->cmp(data, hi) > 0) break;
+        visited++;
+        if (!fn(data, ctx)) break;
+    }
+    return visited;
+}
+
+static TreeNode* _buildBalanced(uint8_t* slab, size_t stride, size_t lo, size_t hi, TreeNode* parent) {
+    if (lo >= hi) return NULL;
+    size_t mid = lo + (hi - lo) / 2;
+    TreeNode* n = (TreeNode*)(slab + mid * stride);
+    n->parent = parent;
+    n->left = _buildBalanced(slab, stride, lo, mid, n);
+    n->right = _buildBalanced(slab, stride, mid + 1, hi, n);
+    _updateNode(n);
+    return n;
+}
+
+Tree treeFromSortedArray(Array arr, int (*cmp)(const void*, const void*)) {
+    if (!arr || !cmp) return NULL;
+    Tree t = treeCreate(arr->esize, cmp);
+
+    uint8_t* src = (uint8_t*)arr->data;
+    size_t n = 0;
+    for (size_t i = 0; i < arr->len; i++)
+        if (i + 1 == arr->len || cmp(src + i * arr->esize, src + (i + 1) * arr->esize) != 0) n++;
+    if (n == 0) return t;
+
+    size_t align = _Alignof(max_align_t);
+    size_t stride = (sizeof(TreeNode) + t->esize + align - 1) & ~(align - 1);
+    uint8_t* slab = (uint8_t*)xMalloc(n * stride);
+
+    for (size_t i = 0, at = 0; i < arr->len; i++) {
+        if (i + 1 < arr->len && cmp(src + i * arr->esize, src + (i + 1) * arr->esize) == 0) continue;
+        TreeNode* node = (TreeNode*)(slab + at++ * stride);
+        node->data = node->storage;
+        node->priority = _nodePriority(node);
+        memcpy(node->data, src + i * arr->esize, t->esize);
+    }
+
+    t->slab = slab;
+    t->slabBytes = n * stride;
+    t->slabLive = n;
+    t->root = _buildBalanced(slab, stride, 0, n, NULL);
+    t->count = n;
+    return t;
+}
+
+Tree treeFromArray(Array arr, int (*cmp)(const void*, const void*)) {
+    if (!arr || !cmp) return NULL;
+    Array sorted = arrayFromPtr(arr->data, arr->len, arr->esize);
+    arraySort(sorted, cmp);
+    Tree t = treeFromSortedArray(sorted, cmp);
+    arrayFree(sorted, NULL);
+    return t;
+}
+
+void treeFreeFast(Tree t) {
+    if (!t) return;
+    if (t->slab && t->slabLive == t->count) {
+        xFree(t->slab);
+        xFree(t);
+        return;
+    }
+    treeFree(t, NULL);
+}
@@ -0,0 +1,605 @@
+#include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "../include/tries.h"
+#include "../include/pointers.h"
+
+#define TRIE_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+static inline bool _isLeaf(const void* p) {
+    return ((uintptr_t)p & 1) != 0;
+}
+
+static inline TrieLeaf* _asLeaf(const void* p) {
+    return (TrieLeaf*)((uintptr_t)p & ~(uintptr_t)1);
+}
+
+static inline void* _tagLeaf(TrieLeaf* l) {
+    return (void*)((uintptr_t)l | 1);
+}
+
+static inline uint8_t* _leafKey(Trie t, TrieLeaf* l) {
+    return (uint8_t*)l->data + t->valueSize;
+}
+
+static inline bool _leafEquals(Trie t, TrieLeaf* l, const uint8_t* key, size_t len) {
+    return l->keyLen == len && memcmp(_leafKey(t, l), key, len) == 0;
+}
+
+static inline bool _leafIsPrefix(Trie t, TrieLeaf* l, const uint8_t* key, size_t len) {
+    return l->keyLen <= len && memcmp(_leafKey(t, l), key, l->keyLen) == 0;
+}
+
+static TrieLeaf* _leafNew(Trie t, const uint8_t* key, size_t len, const void* value) {
+    TrieLeaf* l = (TrieLeaf*)xMalloc(sizeof(TrieLeaf) + t->valueSize + len);
+    l->keyLen = len;
+    if (t->valueSize) {
+        if (value) memcpy(l->data, value, t->valueSize);
+        else memset(l->data, 0, t->valueSize);
+    }
+    if (len) memcpy(_leafKey(t, l), key, len);
+    t->count++;
+    return l;
+}
+
+static void _leafFree(Trie t, TrieLeaf* l, void (*valFree)(void*)) {
+    if (valFree) valFree(l->data);
+    xFree(l);
+    t->count--;
+}
+
+static TrieNode* _nodeNew(TrieNodeType type) {
+    size_t size = type == TRIE_NODE4  ? sizeof(TrieNode4)
+                : type == TRIE_NODE16 ? sizeof(TrieNode16)
+                : type == TRIE_NODE48 ? sizeof(TrieNode48)
+                : sizeof(TrieNode256);
+    TrieNode* n = (TrieNode*)xCalloc(1, size);
+    n->type = (uint8_t)type;
+    return n;
+}
+
+static void _copyHeader(TrieNode* dst, TrieNode* src) {
+    dst->prefixLen = src->prefixLen;
+    dst->count = src->count;
+    dst->leaf = src->leaf;
+    memcpy(dst->prefix, src->prefix, TRIE_PREFIX_MAX);
+}
+
+static void** _findChild(TrieNode* n, uint8_t c) {
+    switch (n->type) {
+        case TRIE_NODE4: {
+            TrieNode4* x = (TrieNode4*)n;
+            for (size_t i = 0; i < n->count; i++)
+                if (x->keys[i] == c) return &x->children[i];
+            return NULL;
+        }
+        case TRIE_NODE16: {
+            TrieNode16* x = (TrieNode16*)n;
+#ifdef __SSE2__
+            __m128i hits = _mm_cmpeq_epi8(_mm_set1_epi8((char)c), _mm_loadu_si128((const __m128i*)x->keys));
+            unsigned mask = (unsigned)_mm_movemask_epi8(hits) & ((1u << n->count) - 1);
+            return mask ? &x->children[__builtin_ctz(mask)] : NULL;
+#else
+            for (size_t i = 0; i < n->count; i++)
+                if (x->keys[i] == c) return &x->children[i];
+            return NULL;
+#endif
+        }
+        case TRIE_NODE48: {
+            TrieNode48* x = (TrieNode48*)n;
+            return x->index[c] ? &x->children[x->index[c] - 1] : NULL;
+        }
+        default: {
+            TrieNode256* x = (TrieNode256*)n;
+            return x->children[c] ? &x->children[c] : NULL;
+        }
+    }
+}
+
+static TrieLeaf* _minLeaf(void* p) {
+    while (p && !_isLeaf(p)) {
+        TrieNode* n = (TrieNode*)p;
+        if (n->leaf) return n->leaf;
+        switch (n->type) {
+            case TRIE_NODE4: p = ((TrieNode4*)n)->children[0]; break;
+            case TRIE_NODE16: p = ((TrieNode16*)n)->children[0]; break;
+            case TRIE_NODE48: {
+                TrieNode48* x = (TrieNode48*)n;
+                size_t c = 0;
+                while (!x->index[c]) c++;
+                p = x->children[x->index[c] - 1];
+                break;
+            }
+            default: {
+                TrieNode256* x = (TrieNode256*)n;
+                size_t c = 0;
+                while (!x->children[c]) c++;
+                p = x->children[c];
+                break;
+            }
+        }
+    }
+    return p ? _asLeaf(p) : NULL;
+}
+
+static void _addChild(void** ref, TrieNode* n, uint8_t c, void* child) {
+    switch (n->type) {
+        case TRIE_NODE4: {
+            TrieNode4* x = (TrieNode4*)n;
+            if (n->count < 4) {
+                size_t pos = 0;
+                while (pos < n->count && x->keys[pos] < c) pos++;
+                memmove(&x->keys[pos + 1], &x->keys[pos], n->count - pos);
+                memmove(&x->children[pos + 1], &x->children[pos], (n->count - pos) * sizeof(void*));
+                x->keys[pos] = c;
+                x->children[pos] = child;
+                n->count++;
+                return;
+            }
+            TrieNode16* grown = (TrieNode16*)_nodeNew(TRIE_NODE16);
+            _copyHeader(&grown->header, n);
+            memcpy(grown->keys, x->keys, 4);
+            memcpy(grown->children, x->children, 4 * sizeof(void*));
+            *ref = grown;
+            xFree(n);
+            _addChild(ref, &grown->header, c, child);
+            return;
+        }
+        case TRIE_NODE16: {
+            TrieNode16* x = (TrieNode16*)n;
+            if (n->count < 16) {
+                size_t pos = 0;
+                while (pos < n->count && x->keys[pos] < c) pos++;
+                memmove(&x->keys[pos + 1], &x->keys[pos], n->count - pos);
+                memmove(&x->children[pos + 1], &x->children[pos], (n->count - pos) * sizeof(void*));
+                x->keys[pos] = c;
+                x->children[pos] = child;
+                n->count++;
+                return;
+            }
+            TrieNode48* grown = (TrieNode48*)_nodeNew(TRIE_NODE48);
+            _copyHeader(&grown->header, n);
+            for (size_t i = 0; i < 16; i++) {
+                grown->index[x->keys[i]] = (uint8_t)(i + 1);
+                grown->children[i] = x->children[i];
+            }
+            *ref = grown;
+            xFree(n);
+            _addChild(ref, &grown->header, c, child);
+            return;
+        }
+        case TRIE_NODE48: {
+            TrieNode48* x = (TrieNode48*)n;
+            if (n->count < 48) {
+                size_t pos = 0;
+                while (x->children[pos]) pos++;
+                x->children[pos] = child;
+                x->index[c] = (uint8_t)(pos + 1);
+                n->count++;
+                return;
+            }
+            TrieNode256* grown = (TrieNode256*)_nodeNew(TRIE_NODE256);
+            _copyHeader(&grown->header, n);
+            for (size_t i = 0; i < 256; i++)
+                if (x->index[i]) grown->children[i] = x->children[x->index[i] - 1];
+            *ref = grown;
+            xFree(n);
+            _addChild(ref, &grown->header, c, child);
+            return;
+        }
+        default: {
+            ((TrieNode256*)n)->children[c] = child;
+            n->count++;
+            return;
+        }
+    }
+}
+
+static void _collapse(void** ref, TrieNode4* x) {
+    TrieNode* n = &x->header;
+    if (n->count == 0) {
+        *ref = n->leaf ? _tagLeaf(n->leaf) : NULL;
+        xFree(n);
+        return;
+    }
+    if (n->count > 1 || n->leaf) return;
+
+    void* child = x->children[0];
+    if (!_isLeaf(child)) {
+        TrieNode* ch = (TrieNode*)child;
+        uint8_t prefix[TRIE_PREFIX_MAX];
+        size_t used = TRIE_MIN(n->prefixLen, TRIE_PREFIX_MAX);
+        memcpy(prefix, n->prefix, used);
+        if (used < TRIE_PREFIX_MAX) prefix[used++] = x->keys[0];
+        size_t take = TRIE_MIN(TRIE_MIN(ch->prefixLen, TRIE_PREFIX_MAX), TRIE_PREFIX_MAX - used);
+        memcpy(prefix + used, ch->prefix, take);
+        memcpy(ch->prefix, prefix, used + take);
+        ch->prefixLen += n->prefixLen + 1;
+    }
+    *ref = child;
+    xFree(n);
+}
+
+static void _removeChild(void** ref, TrieNode* n, uint8_t c, void** slot) {
+    switch (n->type) {
+        case TRIE_NODE4: {
+            TrieNode4* x = (TrieNode4*)n;
+            size_t pos = (size_t)(slot - x->children);
+            memmove(&x->keys[pos], &x->keys[pos + 1], n->count - pos - 1);
+            memmove(&x->children[pos], &x->children[pos + 1], (n->count - pos - 1) * sizeof(void*));
+            n->count--;
+            _collapse(ref, x);
+            return;
+        }
+        case TRIE_NODE16: {
+            TrieNode16* x = (TrieNode16*)n;
+            size_t pos = (size_t)(slot - x->children);
+            memmove(&x->keys[pos], &x->keys[pos + 1], n->count - pos - 1);
+            memmove(&x->children[pos], &x->children[pos + 1], (n->count - pos - 1) * sizeof(void*));
+            n->count--;
+            if (n->count > 3) return;
+            TrieNode4* shrunk = (TrieNode4*)_nodeNew(TRIE_NODE4);
+            _copyHeader(&shrunk->header, n);
+            memcpy(shrunk->keys, x->keys, n->count);
+            memcpy(shrunk->children, x->children, n->count * sizeof(void*));
+            *ref = shrunk;
+            xFree(n);
+            return;
+        }
+        case TRIE_NODE48: {
+            TrieNode48* x = (TrieNode48*)n;
+            x->children[x->index[c] - 1] = NULL;
+            x->index[c] = 0;
+            n->count--;
+            if (n->count > 12) return;
+            TrieNode16* shrunk = (TrieNode16*)_nodeNew(TRIE_NODE16);
+            _copyHeader(&shrunk->header, n);
+            size_t at = 0;
+            for (size_t i = 0; i < 256; i++) {
+                if (!x->index[i]) continue;
+                shrunk->keys[at] = (uint8_t)i;
+                shrunk->children[at++] = x->children[x->index[i] - 1];
+            }
+            *ref = shrunk;
+            xFree(n);
+            return;
+        }
+        default: {
+            TrieNode256* x = (TrieNode256*)n;
+            x->children[c] = NULL;
+            n->count--;
+            if (n->count > 37) return;
+            TrieNode48* shrunk = (TrieNode48*)_nodeNew(TRIE_NODE48);
+            _copyHeader(&shrunk->header, n);
+            size_t at = 0;
+            for (size_t i = 0; i < 256; i++) {
+                if (!x->children[i]) continue;
+                shrunk->children[at] = x->children[i];
+                shrunk->index[i] = (uint8_t)(++at);
+            }
+            *ref = shrunk;
+            xFree(n);
+            return;
+        }
+    }
+}
+
+static size_t _prefixMismatch(Trie t, TrieNode* n, const uint8_t* key, size_t len, size_t depth) {
+    size_t max = TRIE_MIN(TRIE_MIN(n->prefixLen, TRIE_PREFIX_MAX), len - depth);
+    size_t i = 0;
+    for (; i < max; i++)
+        if (n->prefix[i] != key[depth + i]) return i;
+    if (n->prefixLen > TRIE_PREFIX_MAX && i == TRIE_PREFIX_MAX) {
+        TrieLeaf* l = _minLeaf(n);
+        uint8_t* leafKey = _leafKey(t, l);
+        max = TRIE_MIN(n->prefixLen, len - depth);
+        for (; i < max; i++)
+            if (leafKey[depth + i] != key[depth + i]) return i;
+    }
+    return i;
+}
+
+static void _attach(Trie t, void** ref, TrieNode* n, TrieLeaf* l, size_t depth) {
+    if (l->keyLen == depth) n->leaf = l;
+    else _addChild(ref, n, _leafKey(t, l)[depth], _tagLeaf(l));
+}
+
+Trie trieCreate(size_t valueSize) {
+    Trie t = (Trie)xMalloc(sizeof(TrieStruct));
+    t->root = NULL;
+    t->valueSize = valueSize;
+    t->count = 0;
+    return t;
+}
+
+void triePut(Trie t, const char* key, size_t len, void* value) {
+    if (!t || (!key && len)) return;
+    const uint8_t* k = (const uint8_t*)key;
+    void** ref = &t->root;
+    size_t depth = 0;
+
+    while (true) {
+        void* p = *ref;
+        if (!p) {
+            *ref = _tagLeaf(_leafNew(t, k, len, value));
+            return;
+        }
+
+        if (_isLeaf(p)) {
+            TrieLeaf* l = _asLeaf(p);
+            if (_leafEquals(t, l, k, len)) {
+                if (t->valueSize && value) memcpy(l->data, value, t->valueSize);
+                return;
+            }
+            uint8_t* leafKey = _leafKey(t, l);
+            size_t limit = TRIE_MIN(l->keyLen, len);
+            size_t common = depth;
+            while (common < limit && leafKey[common] == k[common]) common++;
+
+            TrieNode* n = _nodeNew(TRIE_NODE4);
+            n->prefixLen = (uint32_t)(common - depth);
+            memcpy(n->prefix, k + depth, TRIE_MIN(n->prefixLen, TRIE_PREFIX_MAX));
+            *ref = n;
+            _attach(t, ref, n, l, common);
+            _attach(t, ref, n, _leafNew(t, k, len, value), common);
+            return;
+        }
+
+        TrieNode* n = (TrieNode*)p;
+        if (n->prefixLen) {
+            size_t m = _prefixMismatch(t, n, k, len, depth);
+            if (m < n->prefixLen) {
+                TrieNode* split = _nodeNew(TRIE_NODE4);
+                split->prefixLen = (uint32_t)m;
+                memcpy(split->prefix, n->prefix, TRIE_MIN(m, TRIE_PREFIX_MAX));
+                *ref = split;
+
+                uint8_t c;
+                if (n->prefixLen <= TRIE_PREFIX_MAX) {
+                    c = n->prefix[m];
+                    n->prefixLen -= (uint32_t)(m + 1);
+                    memmove(n->prefix, n->prefix + m + 1, n->prefixLen);
+                } else {
+                    uint8_t* leafKey = _leafKey(t, _minLeaf(n));
+                    c = leafKey[depth + m];
+                    n->prefixLen -= (uint32_t)(m + 1);
+                    memcpy(n->prefix, leafKey + depth + m + 1, TRIE_MIN(n->prefixLen, TRIE_PREFIX_MAX));
+                }
+                _addChild(ref, split, c, n);
+                _attach(t, ref, split, _leafNew(t, k, len, value), depth + m);
+                return;
+            }
+            depth += n->prefixLen;
+        }
+
+        if (depth == len) {
+            if (n->leaf) {
+                if (t->valueSize && value) memcpy(n->leaf->data, value, t->valueSize);
+            } else {
+                n->leaf = _leafNew(t, k, len, value);
+            }
+            return;
+        }
+
+        void** child = _findChild(n, k[depth]);
+        if (!child) {
+            _addChild(ref, n, k[depth], _tagLeaf(_leafNew(t, k, len, value)));
+            return;
+        }
+        ref = child;
+        depth++;
+    }
+}
+
+static TrieLeaf* _search(Trie t, const uint8_t* key, size_t len) {
+    void* p = t->root;
+    size_t depth = 0;
+    while (p) {
+        if (_isLeaf(p)) {
+            TrieLeaf* l = _asLeaf(p);
+            return _leafEquals(t, l, key, len) ? l : NULL;
+        }
+        TrieNode* n = (TrieNode*)p;
+        if (n->prefixLen) {
+            if (depth + n->prefixLen > len) return NULL;
+            if (memcmp(n->prefix, key + depth, TRIE_MIN(n->prefixLen, TRIE_PREFIX_MAX)) != 0) return NULL;
+            depth += n->prefixLen;
+        }
+        if (depth == len) return n->leaf && _leafEquals(t, n->leaf, key, len) ? n->leaf : NULL;
+        void** child = _findChild(n, key[depth]);
+        if (!child) return NULL;
+        p = *child;
+        depth++;
+    }
+    return NULL;
+}
+
+void* trieGet(Trie t, const char* key, size_t len) {
+    if (!t || (!key && len)) return NULL;
+    TrieLeaf* l = _search(t, (const uint8_t*)key, len);
+    return l ? l->data : NULL;
+}
+
+bool trieContains(Trie t, const char* key, size_t len) {
+    if (!t || (!key && len)) return false;
+    return _search(t, (const uint8_t*)key, len) != NULL;
+}
+
+void trieRemove(Trie t, const char* key, size_t len, void (*valFree)(void*)) {
+    if (!t || (!key && len)) return;
+    const uint8_t* k = (const uint8_t*)key;
+    void** ref = &t->root;
+    void** parentRef = NULL;
+    TrieNode* parent = NULL;
+    size_t depth = 0;
+
+    while (*ref) {
+        void* p = *ref;
+        if (_isLeaf(p)) {
+            TrieLeaf* l = _asLeaf(p);
+            if (!_leafEquals(t, l, k, len)) return;
+            if (parent) _removeChild(parentRef, parent, k[depth - 1], ref);
+            else t->root = NULL;
+            _leafFree(t, l, valFree);
+            return;
+        }
+
+        TrieNode* n = (TrieNode*)p;
+        if (n->prefixLen) {
+            if (depth + n->prefixLen > len) return;
+            if (memcmp(n->prefix, k + depth, TRIE_MIN(n->prefixLen, TRIE_PREFIX_MAX)) != 0) return;
+            depth += n->prefixLen;
+        }
+        if (depth == len) {
+            TrieLeaf* l = n->leaf;
+            if (!l || !_leafEquals(t, l, k, len)) return;
+            n->leaf = NULL;
+            if (n->type == TRIE_NODE4) _collapse(ref, (TrieNode4*)n);
+            _leafFree(t, l, valFree);
+            return;
+        }
+
+        void** child = _findChild(n, k[depth]);
+        if (!child) return;
+        parentRef = ref;
+        parent = n;
+        ref = child;
+        depth++;
+    }
+}
+
+void* trieLongestPrefix(Trie t, const char* key, size_t len, size_t* matchLen) {
+    if (!t || (!key && len)) return NULL;
+    const uint8_t* k = (const uint8_t*)key;
+    TrieLeaf* best = NULL;
+    void* p = t->root;
+    size_t depth = 0;
+
+    while (p) {
+        if (_isLeaf(p)) {
+            if (_leafIsPrefix(t, _asLeaf(p), k, len)) best = _asLeaf(p);
+            break;
+        }
+        TrieNode* n = (TrieNode*)p;
+        if (n->prefixLen) {
+            if (depth + n->prefixLen > len) break;
+            if (memcmp(n->prefix, k + depth, TRIE_MIN(n->prefixLen, TRIE_PREFIX_MAX)) != 0) break;
+            depth += n->prefixLen;
+        }
+        if (n->leaf && _leafIsPrefix(t, n->leaf, k, len)) best = n->leaf;
+        if (depth == len) break;
+        void** child = _findChild(n, k[depth]);
+        if (!child) break;
+        p = *child;
+        depth++;
+    }
+
+    if (!best) return NULL;
+    if (matchLen) *matchLen = best->keyLen;
+    return best->data;
+}
+
+static bool _walk(Trie t, void* p, bool (*fn)(const char*, size_t, void*, void*), void* ctx, size_t* visited) {
+    if (_isLeaf(p)) {
+        TrieLeaf* l = _asLeaf(p);
+        (*visited)++;
+        return fn((const char*)_leafKey(t, l), l->keyLen, l->data, ctx);
+    }
+    TrieNode* n = (TrieNode*)p;
+    if (n->leaf && !_walk(t, _tagLeaf(n->leaf), fn, ctx, visited)) return false;
+    switch (n->type) {
+        case TRIE_NODE4:
+            for (size_t i = 0; i < n->count; i++)
+                if (!_walk(t, ((TrieNode4*)n)->children[i], fn, ctx, visited)) return false;
+            break;
+        case TRIE_NODE16:
+            for (size_t i = 0; i < n->count; i++)
+                if (!_walk(t, ((TrieNode16*)n)->children[i], fn, ctx, visited)) return false;
+            break;
+        case TRIE_NODE48: {
+            TrieNode48* x = (TrieNode48*)n;
+            for (size_t i = 0; i < 256; i++)
+                if (x->index[i] && !_walk(t, x->children[x->index[i] - 1], fn, ctx, visited)) return false;
+            break;
+        }
+        default: {
+            TrieNode256* x = (TrieNode256*)n;
+            for (size_t i = 0; i < 256; i++)
+                if (x->children[i] && !_walk(t, x->children[i], fn, ctx, visited)) return false;
+            break;
+        }
+    }
+    return true;
+}
+
+size_t triePrefixForEach(Trie t, const char* prefix, size_t len, bool (*fn)(const char* key, size_t keyLen, void* value, void* ctx), void* ctx) {
+    if (!t || !fn || (!prefix && len)) return 0;
+    const uint8_t* k = (const uint8_t*)prefix;
+    void* p = t->root;
+    size_t depth = 0;
+
+    while (p && !_isLeaf(p)) {
+        TrieNode* n = (TrieNode*)p;
+        size_t stored = TRIE_MIN(TRIE_MIN(n->prefixLen, TRIE_PREFIX_MAX), len - depth);
+        if (stored && memcmp(n->prefix, k + depth, stored) != 0) return 0;
+        if (depth + n->prefixLen >= len) break;
+        depth += n->prefixLen;
+        void** child = _findChild(n, k[depth]);
+        if (!child) return 0;
+        p = *child;
+        depth++;
+    }
+    if (!p) return 0;
+
+    TrieLeaf* first = _minLeaf(p);
+    if (first->keyLen < len || (len && memcmp(_leafKey(t, first), k, len) != 0)) return 0;
+
+    size_t visited = 0;
+    _walk(t, p, fn, ctx, &visited);
+    return visited;
+}
+
+size_t trieSize(Trie t) {
+    return t ? t->count : 0;
+}
+
+static void _freeNode(Trie t, void* p, void (*valFree)(void*)) {
+    if (_isLeaf(p)) {
+        _leafFree(t, _asLeaf(p), valFree);
+        return;
+    }
+    TrieNode* n = (TrieNode*)p;
+    if (n->leaf) _leafFree(t, n->leaf, valFree);
+    switch (n->type) {
+        case TRIE_NODE4:
+            for (size_t i = 0; i < n->count; i++) _freeNode(t, ((TrieNode4*)n)->children[i], valFree);
+            break;
+        case TRIE_NODE16:
+            for (size_t i = 0; i < n->count; i++) _freeNode(t, ((TrieNode16*)n)->children[i], valFree);
+            break;
+        case TRIE_NODE48:
+            for (size_t i = 0; i < 48; i++)
+                if (((TrieNode48*)n)->children[i]) _freeNode(t, ((TrieNode48*)n)->children[i], valFree);
+            break;
+        default:
+            for (size_t i = 0; i < 256; i++)
+                if (((TrieNode256*)n)->children[i]) _freeNode(t, ((TrieNode256*)n)->children[i], valFree);
+            break;
+    }
+    xFree(n);
+}
+
+void trieClear(Trie t, void (*valFree)(void*)) {
+    if (!t) return;
+    if (t->root) _freeNode(t, t->root, valFree);
+    t->root = NULL;
+    t->count = 0;
+}
+
+void trieFree(Trie t, void (*valFree)(void*)) {
+    if (!t) return;
+    trieClear(t, valFree);
+    xFree(t);
+}
@@ -912,37 +912,40 @@ void tuiDrawHashMap(int x, int y, HashMap map, int (*printKey)(void*, bool), int
     _tuiColorIf(TUI_CYAN);
     printf("HashMap");
     _tuiColorIf(TUI_WHITE);
-    printf(" [Size:%zu | Buckets:%zu]", map->count, map->capacity);
+    printf(" [Size:%zu | %s:%zu]", map->count,
+           map->engine == MAP_ENGINE_SWISS ? "Slots" : "Buckets", map->capacity);
     if (_rawMode) printf("\n");
     int currentY = y + 2;
-    for (size_t i = 0; i < map->capacity; i++) {
+    if (map->count == 0) {
+        _tuiGoToXYIf(x, currentY);
+        _tuiColorIf(TUI_WHITE);
+        printf("( Empty )");
+        if (_rawMode) printf("\n");
+        return;
+    }
+    MapIterator it = mapIterator(map);
+    void* key;
+    void* value;
+    size_t i = 0;
+    while (mapNext(&it, &key, &value)) {
         _tuiGoToXYIf(x, currentY);
         _tuiColorIf(TUI_YELLOW);
-        printf("[%02zu]", i);
+        printf("[%02zu]", i++);
         _tuiColorIf(TUI_DEFAULT);
-        MapEntry* entry = map->buckets[i];
-        if (!entry) {
-            _tuiColorIf(TUI_WHITE);
-            printf(" - NULL");
-        } else {
-            while (entry) {
-                printf(" -> ");
-                _tuiStyleIf(TUI_STYLE_BOLD);
-                printf("[");
-                _tuiColorIf(TUI_GREEN);
-                if (printKey) printKey(entry->key, false);
-                else printf("K");
-                _tuiColorIf(TUI_WHITE);
-                printf(":");
-                _tuiColorIf(TUI_CYAN);
-                if (printVal) printVal(entry->value, false);
-                else printf("V");
-                _tuiColorIf(TUI_DEFAULT);
-                printf("]");
-                _tuiStyleIf(TUI_STYLE_RESET);
-                entry = entry->next;
-            }
-        }
+        printf(" -> ");
+        _tuiStyleIf(TUI_STYLE_BOLD);
+        printf("[");
+        _tuiColorIf(TUI_GREEN);
+        if (printKey) printKey(key, false);
+        else printf("K");
+        _tuiColorIf(TUI_WHITE);
+        printf(":");
+        _tuiColorIf(TUI_CYAN);
+        if (printVal) printVal(value, false);
+        else printf("V");
+        _tuiColorIf(TUI_DEFAULT);
+        printf("]");
+        _tuiStyleIf(TUI_STYLE_RESET);
         if (_rawMode) printf("\n");
         currentY++;
     }
@@ -950,36 +953,38 @@ void tuiDrawHashMap(int x, int y, HashMap map, int (*printKey)(void*, bool), int
 
 void tuiDrawSet(int x, int y, Set set, int (*printKey)(void*, bool)) {
     if (!set) return;
+    HashMap map = set->map;
     _tuiGoToXYIf(x, y);
     _tuiColorIf(TUI_CYAN);
     printf("HashSet");
     _tuiColorIf(TUI_WHITE);
-    printf(" [Size:%zu | Buckets:%zu]", set->map->count, set->map->capacity);
+    printf(" [Size:%zu | %s:%zu]", map->count,
+           map->engine == MAP_ENGINE_SWISS ? "Slots" : "Buckets", map->capacity);
     if (_rawMode) printf("\n");
     int currentY = y + 2;
-    HashMap map = set->map;
-    for (size_t i = 0; i < map->capacity; i++) {
+    if (map->count == 0) {
+        _tuiGoToXYIf(x, currentY);
+        _tuiColorIf(TUI_WHITE);
+        printf("( Empty )");
+        if (_rawMode) printf("\n");
+        return;
+    }
+    MapIterator it = mapIterator(map);
+    void* key;
+    size_t i = 0;
+    while (mapNext(&it, &key, NULL)) {
         _tuiGoToXYIf(x, currentY);
         _tuiColorIf(TUI_YELLOW);
-        printf("[%02zu]", i);
+        printf("[%02zu]", i++);
         _tuiColorIf(TUI_DEFAULT);
-        MapEntry* entry = map->buckets[i];
-        if (!entry) {
-            _tuiColorIf(TUI_WHITE);
-            printf(" - *");
-        } else {
-            while (entry) {
-                printf(" -> ");
-                _tuiStyleIf(TUI_STYLE_BOLD);
-                printf("(");
-                _tuiColorIf(TUI_GREEN);
-                if (printKey) printKey(entry->key, false);
-                _tuiColorIf(TUI_DEFAULT);
-                printf(")");
-                _tuiStyleIf(TUI_STYLE_RESET);
-                entry = entry->next;
-            }
-        }
+        printf(" -> ");
+        _tuiStyleIf(TUI_STYLE_BOLD);
+        printf("(");
+        _tuiColorIf(TUI_GREEN);
+        if (printKey) printKey(key, false);
+        _tuiColorIf(TUI_DEFAULT);
+        printf(")");
+        _tuiStyleIf(TUI_STYLE_RESET);
         if (_rawMode) printf("\n");
         currentY++;
     }
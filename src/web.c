@@ -75,10 +75,7 @@ static void _responseFree(WebResponse *res) {
 }
 
 static HashMap _strHashMapCreate(size_t capacity) {
-    HashMap m = mapCreate(64, sizeof(String), capacity);
-    m->hashFunc = hashString;
-    m->keyEquals = keyEqualsString;
-    return m;
+    return mapCreateStr(sizeof(String), capacity);
 }
 
 static bool _matchRoute(const char *pattern, const char *path, HashMap params) {
@@ -99,11 +96,8 @@ static bool _matchRoute(const char *pattern, const char *path, HashMap params) {
             val[vi] = '\0';
 
             if (params) {
-                char *kCopy = (char *)xMalloc(strlen(key) + 1);
-                strcpy(kCopy, key);
                 String vStr = stringNew(val);
-                mapPut(params, kCopy, &vStr);
-                xFree(kCopy);
+                mapPutStr(params, key, (size_t)ki, &vStr);
             }
         } else if (*p == '*') {
             return true;
@@ -134,11 +128,8 @@ static HashMap _parseQueryString(const char *qs) {
             *eq = '\0';
             char *k = token;
             char *v = eq + 1;
-            char *kCopy = (char *)xMalloc(strlen(k) + 1);
-            strcpy(kCopy, k);
             String vStr = stringNew(v);
-            mapPut(map, kCopy, &vStr);
-            xFree(kCopy);
+            mapPutStr(map, k, (size_t)(eq - token), &vStr);
         }
         token = strtok(NULL, "&");
     }
@@ -179,17 +170,12 @@ static WebRequest *_buildRequest(struct mg_http_message *hm) {
         struct mg_str value = hm->headers[i].value;
         if (name.len == 0) break;
 
-        char *k = (char *)xMalloc(name.len + 1);
-        memcpy(k, name.buf, name.len);
-        k[name.len] = '\0';
-
         char vTmp[1024] = {0};
         size_t vLen = value.len < 1023 ? value.len : 1023;
         memcpy(vTmp, value.buf, vLen);
         String vStr = stringNew(vTmp);
 
-        mapPut(req->headers, k, &vStr);
-        xFree(k);
+        mapPutStr(req->headers, name.buf, name.len, &vStr);
     }
 
     if (hm->body.len > 0) {
@@ -226,24 +212,21 @@ static void _sendResponse(struct mg_connection *c, WebResponse *res, bool corsEn
         stringFree(corsH);
     }
 
-    for (size_t i = 0; i < res->headers->capacity; i++) {
-        MapEntry *entry = res->headers->buckets[i];
-        while (entry) {
-            char *k = (char *)entry->key;
-            String *vPtr = (String *)entry->value;
-            if (vPtr && *vPtr) {
-                String line = stringNew(k);
-                String colon = stringNew(": ");
-                String crlf = stringNew("\r\n");
-                line = stringAppend(line, colon);
-                line = stringAppend(line, *vPtr);
-                line = stringAppend(line, crlf);
-                headers = stringAppend(headers, line);
-                stringFree(colon);
-                stringFree(crlf);
-                stringFree(line);
-            }
-            entry = entry->next;
+    MapIterator it = mapIterator(res->headers);
+    char *k;
+    String *vPtr;
+    while (mapNext(&it, (void **)&k, (void **)&vPtr)) {
+        if (vPtr && *vPtr) {
+            String line = stringNew(k);
+            String colon = stringNew(": ");
+            String crlf = stringNew("\r\n");
+            line = stringAppend(line, colon);
+            line = stringAppend(line, *vPtr);
+            line = stringAppend(line, crlf);
+            headers = stringAppend(headers, line);
+            stringFree(colon);
+            stringFree(crlf);
+            stringFree(line);
         }
     }
 
@@ -317,10 +300,7 @@ static void _webEventHandler(struct mg_connection *c, int ev, void *ev_data) {
         notFound->status = 404;
         stringFree(notFound->body);
         notFound->body = stringNew("{\"error\":\"Not Found\"}");
-        String ctKey = stringNew("Content-Type");
-        String ctVal = stringNew("application/json");
-        mapPut(notFound->headers, stringGetData(ctKey), &ctVal);
-        stringFree(ctKey);
+        webResponseSetHeader(notFound, "Content-Type", "application/json");
         _sendResponse(c, notFound, server->corsEnabled);
         _responseFree(notFound);
     }
@@ -434,10 +414,7 @@ void webResponseSetBodyString(WebResponse *res, String body) {
 void webResponseSetHeader(WebResponse *res, const char *key, const char *value) {
     if (!res || !key) return;
     String vStr = stringNew(value ? value : "");
-    char *kCopy = (char *)xMalloc(strlen(key) + 1);
-    strcpy(kCopy, key);
-    mapPut(res->headers, kCopy, &vStr);
-    xFree(kCopy);
+    mapPutStr(res->headers, key, strlen(key), &vStr);
 }
 
 void webResponseJson(WebResponse *res, int status, const char *json) {
@@ -465,28 +442,19 @@ void webResponseEmpty(WebResponse *res, int status) {
 
 String webRequestGetHeader(WebRequest *req, const char *key) {
     if (!req || !key) return NULL;
-    char *kCopy = (char *)xMalloc(strlen(key) + 1);
-    strcpy(kCopy, key);
-    String *val = (String *)mapGet(req->headers, kCopy);
-    xFree(kCopy);
+    String *val = (String *)mapGetStr(req->headers, key, strlen(key));
     return val ? *val : NULL;
 }
 
 String webRequestGetQuery(WebRequest *req, const char *key) {
     if (!req || !key) return NULL;
-    char *kCopy = (char *)xMalloc(strlen(key) + 1);
-    strcpy(kCopy, key);
-    String *val = (String *)mapGet(req->query, kCopy);
-    xFree(kCopy);
+    String *val = (String *)mapGetStr(req->query, key, strlen(key));
     return val ? *val : NULL;
 }
 
 String webRequestGetParam(WebRequest *req, const char *key) {
     if (!req || !key) return NULL;
-    char *kCopy = (char *)xMalloc(strlen(key) + 1);
-    strcpy(kCopy, key);
-    String *val = (String *)mapGet(req->params, kCopy);
-    xFree(kCopy);
+    String *val = (String *)mapGetStr(req->params, key, strlen(key));
     return val ? *val : NULL;
 }
 
@@ -539,44 +507,39 @@ String webBuildJson(HashMap map) {
     String json = stringNew("{");
     bool first = true;
 
-    for (size_t i = 0; i < map->capacity; i++) {
-        MapEntry *entry = map->buckets[i];
-        while (entry) {
-            char *k = (char *)entry->key;
-            String *vPtr = (String *)entry->value;
-
-            if (!first) {
-                String comma = stringNew(",");
-                json = stringAppend(json, comma);
-                stringFree(comma);
-            }
-            first = false;
-
-            String keyPart = stringNew("\"");
-            String keyStr = stringNew(k);
-            String colon = stringNew("\":\"");
-            String closing = stringNew("\"");
-
-            json = stringAppend(json, keyPart);
-            stringFree(keyPart);
-            json = stringAppend(json, keyStr);
-            stringFree(keyStr);
-            json = stringAppend(json, colon);
-            stringFree(colon);
-
-            if (vPtr && *vPtr) {
-                json = stringAppend(json, *vPtr);
-            } else {
-                String nullStr = stringNew("null");
-                json = stringAppend(json, nullStr);
-                stringFree(nullStr);
-            }
-
-            json = stringAppend(json, closing);
-            stringFree(closing);
-
-            entry = entry->next;
+    MapIterator it = mapIterator(map);
+    char *k;
+    String *vPtr;
+    while (mapNext(&it, (void **)&k, (void **)&vPtr)) {
+        if (!first) {
+            String comma = stringNew(",");
+            json = stringAppend(json, comma);
+            stringFree(comma);
+        }
+        first = false;
+
+        String keyPart = stringNew("\"");
+        String keyStr = stringNew(k);
+        String colon = stringNew("\":\"");
+        String closing = stringNew("\"");
+
+        json = stringAppend(json, keyPart);
+        stringFree(keyPart);
+        json = stringAppend(json, keyStr);
+        stringFree(keyStr);
+        json = stringAppend(json, colon);
+        stringFree(colon);
+
+        if (vPtr && *vPtr) {
+            json = stringAppend(json, *vPtr);
+        } else {
+            String nullStr = stringNew("null");
+            json = stringAppend(json, nullStr);
+            stringFree(nullStr);
         }
+
+        json = stringAppend(json, closing);
+        stringFree(closing);
     }
 
     String end = stringNew("}");
@@ -586,9 +549,7 @@ String webBuildJson(HashMap map) {
 }
 
 HashMap webParseJson(const char *json) {
-    HashMap map = mapCreate(64, sizeof(String), 16);
-    map->hashFunc = hashString;
-    map->keyEquals = keyEqualsString;
+    HashMap map = mapCreateStr(sizeof(String), 16);
 
     if (!json) return map;
 
@@ -599,9 +560,6 @@ HashMap webParseJson(const char *json) {
     cJSON_ArrayForEach(item, root) {
         if (!item->string) continue;
 
-        char *kCopy = (char *)xMalloc(strlen(item->string) + 1);
-        strcpy(kCopy, item->string);
-
         String vStr = NULL;
         if (cJSON_IsString(item) && item->valuestring) {
             vStr = stringNew(item->valuestring);
@@ -622,8 +580,7 @@ HashMap webParseJson(const char *json) {
             if (printed) free(printed);
         }
 
-        mapPut(map, kCopy, &vStr);
-        xFree(kCopy);
+        mapPutStr(map, item->string, strlen(item->string), &vStr);
     }
 
     cJSON_Delete(root);
@@ -669,11 +626,8 @@ static size_t _curlWriteHeaders(char *buffer, size_t size, size_t nitems, void *
         for (size_t i = 0; key[i]; i++) kLower[i] = (char)tolower((unsigned char)key[i]);
         kLower[strlen(key)] = '\0';
 
-        char *kCopy = (char *)xMalloc(strlen(kLower) + 1);
-        strcpy(kCopy, kLower);
         String vStr = stringNew(val);
-        mapPut(headers, kCopy, &vStr);
-        xFree(kCopy);
+        mapPutStr(headers, kLower, strlen(key), &vStr);
         free(kLower);
     }
 
@@ -701,11 +655,8 @@ void webClientOptionsFree(WebClientOptions *opts) {
 
 void webClientOptionsSetHeader(WebClientOptions *opts, const char *key, const char *value) {
     if (!opts || !key) return;
-    char *kCopy = (char *)xMalloc(strlen(key) + 1);
-    strcpy(kCopy, key);
     String vStr = stringNew(value ? value : "");
-    mapPut(opts->headers, kCopy, &vStr);
-    xFree(kCopy);
+    mapPutStr(opts->headers, key, strlen(key), &vStr);
 }
 
 void webClientOptionsSetBody(WebClientOptions *opts, const char *body) {
@@ -756,19 +707,16 @@ WebClientResponse webClientRequest(const char *method, const char *url, WebClien
     struct curl_slist *curlHeaders = NULL;
 
     if (opts && opts->headers) {
-        for (size_t i = 0; i < opts->headers->capacity; i++) {
-            MapEntry *entry = opts->headers->buckets[i];
-            while (entry) {
-                char *k = (char *)entry->key;
-                String *vPtr = (String *)entry->value;
-                if (vPtr && *vPtr) {
-                    size_t hLen = strlen(k) + 2 + stringLength(*vPtr) + 1;
-                    char *hLine = (char *)malloc(hLen);
-                    snprintf(hLine, hLen, "%s: %s", k, stringGetData(*vPtr));
-                    curlHeaders = curl_slist_append(curlHeaders, hLine);
-                    free(hLine);
-                }
-                entry = entry->next;
+        MapIterator it = mapIterator(opts->headers);
+        char *k;
+        String *vPtr;
+        while (mapNext(&it, (void **)&k, (void **)&vPtr)) {
+            if (vPtr && *vPtr) {
+                size_t hLen = strlen(k) + 2 + stringLength(*vPtr) + 1;
+                char *hLine = (char *)malloc(hLen);
+                snprintf(hLine, hLen, "%s: %s", k, stringGetData(*vPtr));
+                curlHeaders = curl_slist_append(curlHeaders, hLine);
+                free(hLine);
             }
         }
     }
@@ -850,13 +798,7 @@ WebClientResponse webClientPost(const char *url, const char *jsonBody, WebClient
 
     if (jsonBody) webClientOptionsSetBody(opts, jsonBody);
 
-    char *existingCT = NULL;
-    if (opts->headers) {
-        char *ctKey = (char *)xMalloc(13);
-        strcpy(ctKey, "Content-Type");
-        existingCT = (char *)mapGet(opts->headers, ctKey);
-        xFree(ctKey);
-    }
+    bool existingCT = opts->headers && mapContainsStr(opts->headers, "Content-Type", 12);
     if (!existingCT)
         webClientOptionsSetHeader(opts, "Content-Type", "application/json");
 
@@ -928,7 +870,7 @@ String webClientGetResponseHeader(WebClientResponse *res, const char *key) {
     char *kLower = (char *)xMalloc(strlen(key) + 1);
     for (size_t i = 0; key[i]; i++) kLower[i] = (char)tolower((unsigned char)key[i]);
     kLower[strlen(key)] = '\0';
-    String *val = (String *)mapGet(res->headers, kLower);
+    String *val = (String *)mapGetStr(res->headers, kLower, strlen(kLower));
     xFree(kLower);
     return val ? *val : NULL;
 }
@@ -967,10 +909,7 @@ String webJsonBuildArray(String *items, size_t count) {
 
 String webJsonGetString(HashMap json, const char *key) {
     if (!json || !key) return NULL;
-    char *kCopy = (char *)xMalloc(strlen(key) + 1);
-    strcpy(kCopy, key);
-    String *val = (String *)mapGet(json, kCopy);
-    xFree(kCopy);
+    String *val = (String *)mapGetStr(json, key, strlen(key));
     return val ? *val : NULL;
 }
 